@@ -70,6 +70,34 @@ typedef ionize_status ( * filament_tx_func )(
     tx_buf const buf
 );
 
+/**
+ * \brief Returns descriptor signalling pending transmissions.
+ * \param self Pointer to filament object on which we operate.
+ * \return Descriptor, -1 if the filament can't be polled.
+ * \see filament_try_rx_func
+ *
+ * The descriptor becomes readable when a transmission can be received
+ * without blocking. It's meant for poll or epoll only, the filament owns it:
+ * it mustn't be read from or closed. With edge-triggered polling readiness
+ * is signalled once, until try_rx returns EAGAIN.
+ */
+typedef int ( * filament_fd_func )( filament const * const self );
+
+/**
+ * \brief Receives transmission if one is pending, without blocking.
+ * \param self Pointer to filament object on which we operate.
+ * \return Structure containing status and received buffer.
+ * \see filament_rx
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid filament given;
+ * 2. EAGAIN - no transmission is pending;
+ * 3. ECONNRESET - the other side is gone, no more transmissions will arrive.
+ */
+typedef filament_rx ( * filament_try_rx_func )(
+    filament const * const self
+);
+
 /*
  * \brief Opaque type holding internal filament state.
  */
@@ -80,6 +108,8 @@ struct filament_struct
     filament_state * state;
     filament_rx_func rx;
     filament_tx_func tx;
+    filament_fd_func fd;
+    filament_try_rx_func try_rx;
 };
 
 /**
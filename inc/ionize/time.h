@@ -0,0 +1,27 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Monotonic time source shared by ionize components.
+ * \date        10/19/2026 09:12:40 AM
+ * \file        time.h
+ * \version     1.0
+ *
+ *
+ **/
+
+#ifndef IONIZE_TIME_H__
+# define IONIZE_TIME_H__
+
+# include <stdint.h> /* uint64_t */
+
+/**
+ * \brief Returns current time, as measured from some arbitrary point.
+ * \return Time in nanoseconds, zero on failure.
+ * \see ionize_log_time
+ *
+ * Unlike ionize_log_time, the time reported here isn't affected by changes
+ * of the wall clock. The starting point is common to all processes on the
+ * host, so values taken by clients and by the daemon can be compared.
+ */
+uint64_t ionize_time( void );
+
+#endif /* IONIZE_TIME_H__ */
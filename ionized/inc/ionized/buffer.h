@@ -0,0 +1,155 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Shared memory buffer managed by ionized.
+ * \date        10/19/2026 01:10:27 PM
+ * \file        buffer.h
+ * \version     1.0
+ *
+ * Each buffer is backed by its own anonymous memory file, so it can be mapped
+ * by clients after receiving the descriptor and its memory can be returned to
+ * the system independently of other buffers.
+ **/
+
+#ifndef IONIZED_BUFFER_H__
+# define IONIZED_BUFFER_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <plasma/allocation.h> /* PLASMA_ALLOCATION_FLAGS */
+# include <plasma/properties.h> /* plasma_properties */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Options of memory backing buffers.
+ *
+ * Values match plasma_allocation_flag, so flags of clients pass through.
+ */
+typedef enum
+{
+    /** Pages are allocated up front, so the first write doesn't fault. */
+    IONIZED_BUFFER_PREFAULT = PLASMA_ALLOCATION_PREFAULT,
+    /** Pages are locked in memory, which allocates them too. */
+    IONIZED_BUFFER_MLOCK = PLASMA_ALLOCATION_MLOCK
+}
+ionized_buffer_flag;
+
+/**
+ * \brief Mask of all buffer flags.
+ */
+# define IONIZED_BUFFER_FLAGS PLASMA_ALLOCATION_FLAGS
+
+/**
+ * \brief Representation of memory buffer.
+ */
+typedef struct
+{
+    int fd; /** Descriptor of memory file backing the buffer. */
+    void * memory; /** Daemon's mapping of the whole file. */
+    size_t size; /** Size of the file and the mapping, in bytes. */
+}
+ionized_buffer;
+
+/**
+ * \brief Declaration of type returned by ionized_buffer_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_buffer buffer; /** Buffer object. */
+}
+ionized_buffer_setup_result;
+
+/**
+ * \brief Creates buffer according to allocation properties.
+ * \param properties Requested properties of the buffer.
+ * \param reserved Number of bytes reserved at the start of the buffer.
+ * \param flags Bitwise or of ionized_buffer_flag values.
+ * \return Structure containing error code and buffer object.
+ * \see plasma_properties
+ *
+ * Tries sizes from maximum down to minimum, decreasing by growing multiples
+ * of the alignment, so a failing allocation doesn't take a step per byte.
+ * Reserved bytes are added on top of the size (e.g. for plasma_header).
+ * Prefaulting takes time proportional to the size, it's meant for startup
+ * or background threads, not the path of a waiting client.
+ * Possible error codes:
+ * 1. codes returned by plasma_properties_validator;
+ * 2. ENOTSUP - flags contain unknown values;
+ * 3. EOVERFLOW - reserved bytes don't fit with maximum size in size_t;
+ * 4. ENOMEM - no size in requested range could be allocated, or its pages
+ *    couldn't be prefaulted;
+ * 5. errno values of memfd_create, if the file couldn't be created;
+ * 6. errno values of mlock, notably EPERM and ENOMEM past RLIMIT_MEMLOCK.
+ */
+ionized_buffer_setup_result ionized_buffer_setup(
+    plasma_properties const properties,
+    size_t const reserved,
+    uint32_t const flags
+);
+
+/**
+ * \brief Allocates pages of part of the buffer.
+ * \param buffer Buffer to prefault.
+ * \param offset Start of the range, a multiple of the page size.
+ * \param length Length of the range, clipped to the end of the buffer.
+ * \return Zero on success, else error code.
+ *
+ * Lets large buffers be prefaulted in parts, by several threads.
+ * Possible error codes:
+ * 1. EINVAL - invalid buffer given;
+ * 2. ENOMEM - pages couldn't be allocated.
+ */
+ionize_status ionized_buffer_prefault(
+    ionized_buffer const * const buffer,
+    size_t const offset,
+    size_t const length
+);
+
+/**
+ * \brief Locks pages of the buffer in memory.
+ * \param buffer Buffer to lock.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid buffer given;
+ * 2. errno values of mlock.
+ */
+ionize_status ionized_buffer_lock( ionized_buffer const * const buffer );
+
+/**
+ * \brief Counts pages of the buffer which aren't resident.
+ * \param buffer Buffer to inspect.
+ * \return Number of pages, zero for invalid buffer.
+ *
+ * Each of them takes a fault on first touch, so for prefaulted or locked
+ * buffers the count should stay zero. Pages reclaimed by the system count
+ * again. Checked with mincore, which takes time proportional to the size.
+ */
+size_t ionized_buffer_cold( ionized_buffer const * const buffer );
+
+/**
+ * \brief Returns pages of the buffer to the system, keeping it mapped.
+ * \param buffer Buffer to release.
+ * \return Zero on success, else error code.
+ *
+ * The memory reads as zeroes afterwards, in all processes mapping it, and
+ * pages are allocated again on first touch. Locked pages can't be released.
+ * Possible error codes:
+ * 1. EINVAL - invalid buffer given;
+ * 2. errno values of madvise.
+ */
+ionize_status ionized_buffer_release( ionized_buffer const * const buffer );
+
+/**
+ * \brief Destroys buffer, returning its memory to the system.
+ * \param buffer Buffer to destroy.
+ * \return Zero on success, else error code.
+ * \warning Clients' mappings keep the memory alive until they are unmapped.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid buffer given;
+ * 2. EIO - unmapping or closing the file failed.
+ */
+ionize_status ionized_buffer_cleanup( ionized_buffer * const buffer );
+
+#endif /* IONIZED_BUFFER_H__ */
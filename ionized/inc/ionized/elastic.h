@@ -0,0 +1,111 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Automatic scaling of queue depth.
+ * \date        10/20/2026 09:14:22 AM
+ * \file        elastic.h
+ * \version     1.0
+ *
+ * The daemon periodically steps an ionized_elastic object for each queue.
+ * Each step looks at the queue's statistics since the previous step. Once
+ * writers had to wait for a buffer or got EAGAIN in a few steps in a row,
+ * the queue grows by half of its buffers, as far as its memory budget
+ * allows, and the count starts over; a single burst doesn't grow it. If no
+ * writer was starved and some buffers stayed free for the whole period,
+ * up to half of those surplus buffers are retired, only ones which stayed
+ * free for the idle time.
+ *
+ * Under memory pressure growth is speculative, so it's refused. All free
+ * buffers above the minimum are retired at once, and the pages of the rest
+ * are returned to the system.
+ **/
+
+#ifndef IONIZED_ELASTIC_H__
+# define IONIZED_ELASTIC_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <ionized/pressure.h> /* ionized_pressure */
+# include <ionized/queue.h> /* ionized_queue */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* int64_t, uint32_t, uint64_t */
+
+/**
+ * \brief Default time after which surplus buffers are retired, in ns.
+ */
+# define IONIZED_ELASTIC_IDLE 10000000000U
+
+/**
+ * \brief Default number of starved steps in a row before the queue grows.
+ */
+# define IONIZED_ELASTIC_PATIENCE 3U
+
+/**
+ * \brief Scaling policy of a single queue.
+ *
+ * Only budget has to be set, zeroes in other fields select defaults.
+ */
+typedef struct
+{
+    size_t budget; /** Memory the queue may hold, in bytes. */
+    size_t minimum; /** Buffers never retired, default is one. */
+    uint64_t idle; /** Time after which surplus is retired, in ns. */
+    ionized_pressure * pressure; /** Monitor of memory, may be NULL. */
+    uint32_t patience; /** Starved steps in a row before growing. */
+}
+ionized_elastic_policy;
+
+/**
+ * \brief State of scaling of a single queue.
+ */
+typedef struct
+{
+    ionized_elastic_policy policy; /** Policy with defaults filled in. */
+    uint64_t starved; /** Waits and EAGAINs seen until previous step. */
+    uint32_t streak; /** Steps in a row which saw starved writers. */
+}
+ionized_elastic;
+
+/**
+ * \brief Declaration of type returned by ionized_elastic_step.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    int64_t change; /** Number of buffers added, negative if retired. */
+}
+ionized_elastic_step_result;
+
+/**
+ * \brief Initializes scaling state.
+ * \param self Scaling state to initialize.
+ * \param policy Scaling policy.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid self given or budget is zero.
+ */
+ionize_status ionized_elastic_init(
+    ionized_elastic * const self,
+    ionized_elastic_policy const policy
+);
+
+/**
+ * \brief Grows or shrinks the queue according to its recent usage.
+ * \param self Scaling state of the queue.
+ * \param queue Queue to scale.
+ * \return Structure with error code and number of buffers changed.
+ * \see ionized_queue_stats
+ * \see ionized_pressure
+ *
+ * New buffers have the same properties as the last ones allocated in the
+ * queue, so a queue never allocated by a client isn't scaled. They are
+ * charged to the queue's budget only, as IONIZED_QUOTA_DAEMON allocation.
+ * Possible error codes:
+ * 1. EINVAL - invalid self or queue given;
+ * 2. codes returned by queue's allocate, prune and trim methods.
+ */
+ionized_elastic_step_result ionized_elastic_step(
+    ionized_elastic * const self,
+    ionized_queue * const queue
+);
+
+#endif /* IONIZED_ELASTIC_H__ */
@@ -0,0 +1,147 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Latency histograms of buffers passing through a queue.
+ * \date        10/19/2026 11:02:35 AM
+ * \file        latency.h
+ * \version     1.0
+ *
+ * Every circular queue managed by ionized owns one ionized_latency object.
+ * The queue stamps write lock, commit, read lock and read unlock times of
+ * sampled buffers and records the differences here. Histograms are updated
+ * with atomic operations only, so they can be read from a live daemon at any
+ * time without stopping traffic.
+ **/
+
+#ifndef IONIZED_LATENCY_H__
+# define IONIZED_LATENCY_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stdatomic.h> /* atomic_uint_fast64_t */
+# include <stdbool.h> /* bool */
+# include <stdint.h> /* uint32_t, uint64_t */
+
+/**
+ * \brief Number of buckets in each histogram.
+ *
+ * Bucket i counts durations d (in nanoseconds) with 2^i <= d < 2^(i+1),
+ * with the exception of bucket zero, which counts durations below 2ns.
+ */
+# define IONIZED_LATENCY_BUCKETS 64U
+
+/**
+ * \brief Kinds of durations traced for each buffer.
+ */
+typedef enum
+{
+    IONIZED_LATENCY_WRITE_HOLD, /** From write lock to commit. */
+    IONIZED_LATENCY_QUEUEING, /** From commit to first read lock. */
+    IONIZED_LATENCY_READ_HOLD, /** From read lock to its unlock. */
+    IONIZED_LATENCY_KINDS /** Number of kinds, not a valid kind. */
+}
+ionized_latency_kind;
+
+/**
+ * \brief Times of buffer events, kept by the queue for each buffer.
+ * \see ionize_time
+ *
+ * Zero means the event didn't happen since the last write lock, or that the
+ * buffer isn't sampled.
+ */
+typedef struct
+{
+    uint64_t write_lock; /** Time the buffer was locked for writing. */
+    uint64_t commit; /** Time the buffer was committed. */
+    uint64_t read_lock; /** Time of first read lock after commit. */
+}
+ionized_latency_stamps;
+
+/**
+ * \brief Latency histograms of a single circular queue.
+ */
+typedef struct
+{
+    uint32_t sampling; /** Every 2^sampling-th buffer is traced. */
+    atomic_uint_fast64_t cycles; /** Number of write locks seen. */
+    atomic_uint_fast64_t
+        buckets[ IONIZED_LATENCY_KINDS ][ IONIZED_LATENCY_BUCKETS ];
+}
+ionized_latency;
+
+/**
+ * \brief Plain copy of histograms, taken by ionized_latency_snapshot.
+ */
+typedef struct
+{
+    uint64_t cycles; /** Number of write locks seen. */
+    uint64_t buckets[ IONIZED_LATENCY_KINDS ][ IONIZED_LATENCY_BUCKETS ];
+}
+ionized_latency_snapshot_result;
+
+/**
+ * \brief Initializes latency histograms.
+ * \param self Histograms to initialize.
+ * \param sampling Binary logarithm of sampling period, zero traces all.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid self given;
+ * 2. ERANGE - sampling period doesn't fit in 64 bits.
+ */
+ionize_status ionized_latency_init(
+    ionized_latency * const self,
+    uint32_t const sampling
+);
+
+/**
+ * \brief Decides whether buffer locked for writing will be traced.
+ * \param self Histograms of the queue.
+ * \return True if the buffer should be stamped.
+ *
+ * Called once per write lock. This method is thread-safe.
+ */
+bool ionized_latency_sample( ionized_latency * const self );
+
+/**
+ * \brief Records a single duration.
+ * \param self Histograms of the queue.
+ * \param kind Kind of the duration.
+ * \param from Time the duration started at.
+ * \param to Time the duration ended at.
+ *
+ * Nothing is recorded if from is zero (event wasn't stamped) or if to
+ * precedes from. This method is thread-safe.
+ */
+void ionized_latency_record(
+    ionized_latency * const self,
+    ionized_latency_kind const kind,
+    uint64_t const from,
+    uint64_t const to
+);
+
+/**
+ * \brief Copies current state of histograms.
+ * \param self Histograms of the queue.
+ * \return Copy of histograms.
+ *
+ * The copy isn't atomic as a whole, buckets updated while copying may or may
+ * not be included. This method is thread-safe.
+ */
+ionized_latency_snapshot_result
+ionized_latency_snapshot( ionized_latency * const self );
+
+/**
+ * \brief Estimates quantile of durations of given kind.
+ * \param snapshot Copy of histograms.
+ * \param kind Kind of durations.
+ * \param permille Requested quantile, in thousandths (500 gives median).
+ * \return Upper bound of the bucket holding the quantile, in nanoseconds.
+ *
+ * Returns zero if there are no recorded durations of given kind.
+ */
+uint64_t ionized_latency_quantile(
+    ionized_latency_snapshot_result const * const snapshot,
+    ionized_latency_kind const kind,
+    uint32_t const permille
+);
+
+#endif /* IONIZED_LATENCY_H__ */
@@ -0,0 +1,194 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Event loop serving client connections of the daemon.
+ * \date        10/21/2026 10:02:37 AM
+ * \file        loop.h
+ * \version     1.0
+ *
+ * A single thread watches all client filaments, through epoll or io_uring,
+ * see ionized_loop_backend, and hands every received transmission to the
+ * handler given for the client.
+ * Idle clients cost a descriptor and a small record, never a thread. Each
+ * client is drained in batches: one sending faster than it's served doesn't
+ * starve the others, it's resumed on the next run without waiting.
+ **/
+
+#ifndef IONIZED_LOOP_H__
+# define IONIZED_LOOP_H__
+
+# include <filament/filament.h> /* filament, filament_rx */
+# include <ionize/error.h> /* ionize_status */
+# include <stddef.h> /* size_t */
+
+/**
+ * \brief Maximum number of readiness events taken by single run.
+ */
+# define IONIZED_LOOP_EVENTS 256U
+
+/**
+ * \brief Maximum number of transmissions received from client in one run.
+ */
+# define IONIZED_LOOP_BATCH 64U
+
+typedef struct ionized_loop_struct ionized_loop;
+
+/**
+ * \brief Handles a transmission received from a client.
+ * \param context Pointer given when the client was watched.
+ * \param client Filament the transmission came from.
+ * \param rx Received transmission, its buffer belongs to the handler.
+ * \return Zero to keep watching the client, else it's unwatched.
+ *
+ * Failed receptions are handed over as well, with empty buffer. The client
+ * is unwatched after them regardless of the returned value, so the handler
+ * can release whatever it keeps for the client.
+ */
+typedef ionize_status ( * ionized_loop_handler )(
+    void * const context,
+    filament const * const client,
+    filament_rx const rx
+);
+
+/**
+ * \brief Starts watching a client.
+ * \param self Loop on which we'll operate.
+ * \param client Filament of the client, polled through its fd method.
+ * \param handler Called for every transmission from the client.
+ * \param context Passed to the handler.
+ * \return Zero on success, else error code.
+ *
+ * Transmissions pending already are handled on the next run.
+ * Possible error codes:
+ * 1. EINVAL - invalid loop, client or handler given;
+ * 2. ENOTSUP - the client can't be polled;
+ * 3. EEXIST - the client is watched already;
+ * 4. ENOMEM - no memory to track the client;
+ * 5. codes returned by ionized_loop_backend_add.
+ */
+typedef ionize_status ( * ionized_loop_watch_func )(
+    ionized_loop * const self,
+    filament const * const client,
+    ionized_loop_handler const handler,
+    void * const context
+);
+
+/**
+ * \brief Stops watching a client.
+ * \param self Loop on which we'll operate.
+ * \param client Filament of the client.
+ * \return Zero on success, else error code.
+ *
+ * May be called from handlers, for any client. The handler isn't called for
+ * the client afterwards, even for transmissions received already.
+ * Possible error codes:
+ * 1. EINVAL - invalid loop or client given;
+ * 2. ENOENT - the client isn't watched.
+ */
+typedef ionize_status ( * ionized_loop_unwatch_func )(
+    ionized_loop * const self,
+    filament const * const client
+);
+
+/**
+ * \brief Declaration of type returned by ionized_loop_run_func.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    size_t handled; /** Number of transmissions handed to handlers. */
+}
+ionized_loop_run_result;
+
+/**
+ * \brief Waits for transmissions and handles them.
+ * \param self Loop on which we'll operate.
+ * \param timeout Maximum wait in milliseconds, -1 waits indefinitely.
+ * \return Structure with error code and number of handled transmissions.
+ *
+ * Runs a single iteration, the daemon calls it in a loop of its own, doing
+ * periodic work between runs. Doesn't wait if some client still has pending
+ * transmissions from the previous run. Returns early when woken.
+ * Possible error codes:
+ * 1. EINVAL - invalid loop given;
+ * 2. ENOMEM - no memory to track clients with pending transmissions;
+ * 3. codes returned by ionized_loop_backend_wait.
+ */
+typedef ionized_loop_run_result ( * ionized_loop_run_func )(
+    ionized_loop * const self,
+    int const timeout
+);
+
+/**
+ * \brief Makes current or next run return without waiting.
+ * \param self Loop on which we'll operate.
+ * \return Zero on success, else error code.
+ *
+ * It's the only method which may be called from other threads, for example
+ * to stop the daemon.
+ * Possible error codes:
+ * 1. EINVAL - invalid loop given;
+ * 2. EIO - couldn't signal the loop.
+ */
+typedef ionize_status ( * ionized_loop_wake_func )( ionized_loop * const self );
+
+/**
+ * \brief Returns number of watched clients.
+ * \param self Loop on which we'll operate.
+ * \return Number of clients, zero for invalid loop.
+ */
+typedef size_t ( * ionized_loop_watched_func )(
+    ionized_loop const * const self
+);
+
+/**
+ * \brief Opaque type holding internal loop state.
+ */
+typedef struct ionized_loop_state_struct ionized_loop_state;
+
+/**
+ * \brief Representation of the event loop.
+ */
+struct ionized_loop_struct
+{
+    ionized_loop_state * state; /** Internal state. */
+    ionized_loop_watch_func watch; /** Starts watching client. */
+    ionized_loop_unwatch_func unwatch; /** Stops watching client. */
+    ionized_loop_run_func run; /** Handles pending transmissions. */
+    ionized_loop_wake_func wake; /** Interrupts waiting run. */
+    ionized_loop_watched_func watched; /** Counts watched clients. */
+};
+
+/**
+ * \brief Declaration of type returned by ionized_loop_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_loop loop; /** Loop object, valid on success. */
+}
+ionized_loop_setup_result;
+
+/**
+ * \brief Creates a loop watching no clients.
+ * \return Structure containing error code and loop object.
+ *
+ * Possible error codes:
+ * 1. ENOMEM - couldn't allocate memory for loop state;
+ * 2. codes returned by ionized_loop_backend_setup.
+ */
+ionized_loop_setup_result ionized_loop_setup( void );
+
+/**
+ * \brief Destroys the loop.
+ * \param loop Loop to destroy.
+ * \return Zero on success, else error code.
+ * \warning Mustn't be called from a handler.
+ *
+ * Clients still watched are forgotten, their filaments are left intact.
+ * Possible error codes:
+ * 1. EINVAL - invalid loop given;
+ * 2. codes returned by ionized_loop_backend_cleanup.
+ */
+ionize_status ionized_loop_cleanup( ionized_loop * const loop );
+
+#endif /* IONIZED_LOOP_H__ */
@@ -0,0 +1,135 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Readiness notification used by the event loop.
+ * \date        10/22/2026 02:10:33 PM
+ * \file        backend.h
+ * \version     1.0
+ *
+ * The event loop keeps clients and dispatches transmissions, the backend
+ * only reports which descriptors became readable. Exactly one backend is
+ * built into the daemon:
+ * 1. ionized/src/loop/epoll.c - edge-triggered epoll, works everywhere;
+ * 2. ionized/src/loop/uring.c - io_uring with multishot polls on registered
+ *    files, needs liburing. Each client costs one submission for as long as
+ *    it's watched, and completions are reaped from shared memory, so busy
+ *    loops make far fewer system calls. Descriptors must be below the open
+ *    file limit the daemon had when the backend was set up.
+ **/
+
+#ifndef IONIZED_LOOP_BACKEND_H__
+# define IONIZED_LOOP_BACKEND_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stddef.h> /* size_t */
+
+/**
+ * \brief Opaque type holding backend state.
+ */
+typedef struct ionized_loop_backend_struct ionized_loop_backend;
+
+/**
+ * \brief Declaration of type returned by ionized_loop_backend_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_loop_backend * backend; /** Allocated backend, valid on success. */
+}
+ionized_loop_backend_setup_result;
+
+/**
+ * \brief Creates backend watching no descriptors.
+ * \return Structure with error code and backend.
+ *
+ * Possible error codes:
+ * 1. ENOMEM - couldn't allocate memory for backend;
+ * 2. codes set by system calls creating the backend.
+ */
+ionized_loop_backend_setup_result ionized_loop_backend_setup( void );
+
+/**
+ * \brief Starts watching descriptor for readability.
+ * \param self Backend on which we'll operate.
+ * \param fd Descriptor to watch.
+ * \param tag Reported when the descriptor becomes readable, not NULL.
+ * \return Zero on success, else error code.
+ *
+ * Readiness is reported once per change, like edge-triggered epoll. The
+ * descriptor should be read until EAGAIN, else it may not be reported again.
+ * Possible error codes:
+ * 1. ENOSPC - too many descriptors watched, or descriptor past the table;
+ * 2. EEXIST - descriptor watched already;
+ * 3. EAGAIN - no room for the request registering the descriptor;
+ * 4. codes set by system calls registering the descriptor.
+ */
+ionize_status ionized_loop_backend_add(
+    ionized_loop_backend * const self,
+    int const fd,
+    void * const tag
+);
+
+/**
+ * \brief Stops watching descriptor.
+ * \param self Backend on which we'll operate.
+ * \param fd Descriptor watched.
+ * \param tag Tag given when the descriptor was added.
+ *
+ * The tag isn't reported afterwards, even if it was ready already.
+ */
+void ionized_loop_backend_remove(
+    ionized_loop_backend * const self,
+    int const fd,
+    void * const tag
+);
+
+/**
+ * \brief Declaration of type returned by ionized_loop_backend_wait.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    size_t count; /** Number of tags stored. */
+}
+ionized_loop_backend_wait_result;
+
+/**
+ * \brief Waits until some descriptors become readable or backend is woken.
+ * \param self Backend on which we'll operate.
+ * \param tags Receives tags of readable descriptors.
+ * \param capacity Number of tags which fit.
+ * \param timeout Maximum wait in milliseconds, -1 waits indefinitely.
+ * \return Structure with error code and number of tags.
+ *
+ * Interrupted waits return no tags and no error. Tags not fitting are left
+ * for the next call.
+ * Possible error codes:
+ * 1. codes set by the system call waiting.
+ */
+ionized_loop_backend_wait_result ionized_loop_backend_wait(
+    ionized_loop_backend * const self,
+    void * * const tags,
+    size_t const capacity,
+    int const timeout
+);
+
+/**
+ * \brief Makes current or next wait return, may be called from any thread.
+ * \param self Backend on which we'll operate.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EIO - couldn't signal the backend.
+ */
+ionize_status ionized_loop_backend_wake( ionized_loop_backend * const self );
+
+/**
+ * \brief Destroys backend.
+ * \param self Backend to destroy.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EIO - descriptors couldn't be closed.
+ */
+ionize_status ionized_loop_backend_cleanup( ionized_loop_backend * const self );
+
+#endif /* IONIZED_LOOP_BACKEND_H__ */
@@ -0,0 +1,152 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Queues created and filled with buffers at startup.
+ * \date        10/23/2026 02:17:45 PM
+ * \file        manifest.h
+ * \version     1.0
+ *
+ * Buffers allocated on demand cost the first burst of clients memory file
+ * creation, mapping and a page fault per page. The manifest lists queues
+ * known in advance, so the daemon creates them, allocates their buffers and
+ * prefaults them on all cores of the pool before accepting clients.
+ *
+ * The manifest is text, one queue per line, fields separated by blanks:
+ *
+ *     # name     uid  count  minimum  maximum  alignment  options...
+ *     telemetry  17   64     65536    65536    16         header prefault
+ *
+ * Name identifies the queue in logs, clients still use the uid. Numbers may
+ * be decimal, octal or hexadecimal. Options are flags of plasma_config, as
+ * header, overwrite, latest and priority, and flags of ionized_buffer, as
+ * prefault and mlock. Text from # to the end of line is ignored.
+ **/
+
+#ifndef IONIZED_MANIFEST_H__
+# define IONIZED_MANIFEST_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <ionized/pool.h> /* ionized_pool */
+# include <ionized/shard.h> /* ionized_shard */
+# include <plasma/config.h> /* plasma_config */
+# include <plasma/properties.h> /* plasma_properties */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Size of the longest name, including the terminating null.
+ */
+# define IONIZED_MANIFEST_NAME 64U
+
+/**
+ * \brief Most buffers a single queue of the manifest may list.
+ */
+# define IONIZED_MANIFEST_BUFFERS 65536U
+
+/**
+ * \brief Queue described by the manifest.
+ */
+typedef struct
+{
+    char name[ IONIZED_MANIFEST_NAME ]; /** Name used in logs. */
+    uint32_t uid; /** Unique identifier of the queue. */
+    size_t count; /** Number of buffers allocated. */
+    plasma_properties properties; /** Properties of each buffer. */
+    plasma_config config; /** Configuration of the queue. */
+    uint32_t backing; /** Bitwise or of ionized_buffer_flag values. */
+}
+ionized_manifest_entry;
+
+/**
+ * \brief Representation of the manifest.
+ */
+typedef struct
+{
+    ionized_manifest_entry * entries; /** Queues in order of lines. */
+    size_t count; /** Number of entries. */
+}
+ionized_manifest;
+
+/**
+ * \brief Declaration of type returned by ionized_manifest_parse.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    size_t line; /** Line with the error, zero if no line is at fault. */
+    ionized_manifest manifest; /** Manifest object, valid on success. */
+}
+ionized_manifest_parse_result;
+
+/**
+ * \brief Parses text of the manifest.
+ * \param text Null-terminated text.
+ * \return Structure with error code, faulty line and manifest object.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid text given, a line misses fields or has a number
+ *    which doesn't fit, or zero buffers or more than
+ *    IONIZED_MANIFEST_BUFFERS;
+ * 2. ENAMETOOLONG - name doesn't fit in IONIZED_MANIFEST_NAME;
+ * 3. ENOTSUP - unknown option;
+ * 4. EEXIST - the uid is listed already;
+ * 5. ENOMEM - no memory for the manifest;
+ * 6. codes returned by plasma_properties_validator.
+ */
+ionized_manifest_parse_result ionized_manifest_parse( char const * const text );
+
+/**
+ * \brief Reads and parses the manifest file.
+ * \param path Path of the file.
+ * \return Structure with error code, faulty line and manifest object.
+ * \see ionized_manifest_parse
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid path given;
+ * 2. EIO - the file couldn't be read;
+ * 3. codes set by fopen;
+ * 4. codes returned by ionized_manifest_parse.
+ */
+ionized_manifest_parse_result ionized_manifest_load( char const * const path );
+
+/**
+ * \brief Creates the queues of the manifest and allocates their buffers.
+ * \param manifest Manifest listing the queues.
+ * \param shards Array of shards of the daemon, not started yet.
+ * \param count Length of shards array.
+ * \param pool Pool allocating buffers, NULL allocates on this thread.
+ * \param producer Deque of the pool used by this thread.
+ * \return Zero on success, else error code.
+ * \see ionized_pool_submit_func
+ *
+ * Queues are created by the shards owning them, then every buffer is a task
+ * of the pool, so memory of large manifests is mapped and prefaulted by all
+ * workers at once. The call returns once all of them are done. Buffers are
+ * charged to client zero, the daemon itself. Buffers allocated before the
+ * first failure are kept.
+ * Possible error codes:
+ * 1. EINVAL - invalid manifest or shards given, or buffers of all queues
+ *    can't be counted;
+ * 2. EIO - synchronization primitives couldn't be initialized;
+ * 3. ENOMEM - no memory for the tasks;
+ * 4. codes returned by the shards' queue method and the queues' configure,
+ *    backing and allocate methods.
+ */
+ionize_status ionized_manifest_warm(
+    ionized_manifest const * const manifest,
+    ionized_shard * const * const shards,
+    uint32_t const count,
+    ionized_pool * const pool,
+    size_t const producer
+);
+
+/**
+ * \brief Destroys the manifest.
+ * \param manifest Manifest to destroy.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid manifest given.
+ */
+ionize_status ionized_manifest_cleanup( ionized_manifest * const manifest );
+
+#endif /* IONIZED_MANIFEST_H__ */
@@ -0,0 +1,143 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Work-stealing thread pool for background work of the daemon.
+ * \date        10/22/2026 09:20:14 AM
+ * \file        pool.h
+ * \version     1.0
+ *
+ * Shards hand slow work, like zeroing retired buffers, prefaulting new ones
+ * or aggregating statistics, to the pool instead of doing it on their event
+ * loop. Every shard pushes to a deque of its own, without locks. Every worker
+ * has a deque too, for tasks submitted by tasks. Workers take from their own
+ * deque first and, once it's empty, steal the oldest tasks of other deques,
+ * so a burst on one shard is spread over all idle workers.
+ **/
+
+#ifndef IONIZED_POOL_H__
+# define IONIZED_POOL_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint64_t */
+
+/**
+ * \brief Capacity of each deque, a power of two.
+ */
+# define IONIZED_POOL_DEPTH 1024U
+
+typedef struct ionized_task_struct ionized_task;
+
+/**
+ * \brief Runs a task.
+ * \param task The task, still owned by whoever submitted it.
+ */
+typedef void ( * ionized_task_func )( ionized_task * const task );
+
+/**
+ * \brief Task run by the pool.
+ *
+ * The pool doesn't copy tasks, they must stay valid until they're run.
+ * Embedding the task in the structure describing the work does that.
+ */
+struct ionized_task_struct
+{
+    ionized_task_func run; /** Function running the task. */
+    void * context; /** Free for use by the function. */
+};
+
+typedef struct ionized_pool_struct ionized_pool;
+
+/**
+ * \brief Queues task to be run by a worker.
+ * \param self Pool on which we'll operate.
+ * \param producer Deque of the calling thread, ignored when called by task.
+ * \param task Task to run.
+ * \return Zero on success, else error code.
+ *
+ * Each producer deque must be used by one thread only, usually a shard uses
+ * its index. Tasks submitting tasks push to the deque of their worker.
+ * Possible error codes:
+ * 1. EINVAL - invalid pool or task given;
+ * 2. ERANGE - no such producer;
+ * 3. EAGAIN - the deque is full, the caller may run the task itself.
+ */
+typedef ionize_status ( * ionized_pool_submit_func )(
+    ionized_pool * const self,
+    size_t const producer,
+    ionized_task * const task
+);
+
+/**
+ * \brief Counters of the pool.
+ */
+typedef struct
+{
+    uint64_t executed; /** Tasks run so far. */
+    uint64_t stolen; /** Tasks run by a worker other than the deque's owner. */
+}
+ionized_pool_stats;
+
+/**
+ * \brief Reads counters of the pool.
+ * \param self Pool on which we'll operate.
+ * \return Counters, all zeroes for invalid pool.
+ */
+typedef ionized_pool_stats ( * ionized_pool_stats_func )(
+    ionized_pool const * const self
+);
+
+/**
+ * \brief Opaque type holding internal pool state.
+ */
+typedef struct ionized_pool_state_struct ionized_pool_state;
+
+/**
+ * \brief Representation of the pool.
+ */
+struct ionized_pool_struct
+{
+    ionized_pool_state * state; /** Internal state. */
+    ionized_pool_submit_func submit; /** Queues task. */
+    ionized_pool_stats_func stats; /** Reads counters. */
+};
+
+/**
+ * \brief Declaration of type returned by ionized_pool_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_pool pool; /** Pool object, valid on success. */
+}
+ionized_pool_setup_result;
+
+/**
+ * \brief Creates a pool and starts its workers.
+ * \param workers Number of worker threads.
+ * \param producers Number of threads submitting tasks, usually shards.
+ * \return Structure containing error code and pool object.
+ *
+ * Possible error codes:
+ * 1. EINVAL - zero workers;
+ * 2. ENOMEM - couldn't allocate memory for pool state;
+ * 3. EIO - synchronization primitives couldn't be initialized;
+ * 4. codes returned by pthread_create.
+ */
+ionized_pool_setup_result ionized_pool_setup(
+    size_t const workers,
+    size_t const producers
+);
+
+/**
+ * \brief Runs all queued tasks, then stops workers and destroys the pool.
+ * \param pool Pool to destroy.
+ * \return Zero on success, else error code.
+ * \warning No task may be submitted during or after cleanup.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid pool given;
+ * 2. EIO - workers couldn't be joined.
+ */
+ionize_status ionized_pool_cleanup( ionized_pool * const pool );
+
+#endif /* IONIZED_POOL_H__ */
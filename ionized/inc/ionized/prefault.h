@@ -0,0 +1,51 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Prefaulting of buffers by workers of the pool.
+ * \date        10/24/2026 09:36:12 AM
+ * \file        prefault.h
+ * \version     1.0
+ *
+ * Populating pages of a large buffer takes one thread a while, the kernel
+ * zeroes every page it hands out. The buffers are cut into chunks, which
+ * workers of the pool and the calling thread take in turns, so the work
+ * spreads over all cores and the caller returns once the last chunk is done.
+ **/
+
+#ifndef IONIZED_PREFAULT_H__
+# define IONIZED_PREFAULT_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <ionized/buffer.h> /* ionized_buffer */
+# include <ionized/pool.h> /* ionized_pool */
+# include <stddef.h> /* size_t */
+
+/**
+ * \brief Length of memory one task prefaults, in bytes.
+ */
+# define IONIZED_PREFAULT_CHUNK (( size_t ) 2U << 20 )
+
+/**
+ * \brief Allocates all pages of the buffers.
+ * \param buffers Array of buffers to prefault.
+ * \param count Length of buffers array.
+ * \param pool Pool helping with chunks, NULL prefaults on this thread.
+ * \param producer Deque of the pool used by this thread.
+ * \return Zero on success, else error code.
+ * \see ionized_buffer_prefault
+ * \see ionized_pool_submit_func
+ *
+ * The calling thread works on chunks too, so the call completes even when
+ * all workers are busy. Helpers starting late find no chunks left.
+ * Possible error codes:
+ * 1. EINVAL - invalid buffers given;
+ * 2. EIO - synchronization primitives couldn't be initialized;
+ * 3. ENOMEM - no memory for the helpers, or pages couldn't be allocated.
+ */
+ionize_status ionized_prefault(
+    ionized_buffer const * const buffers,
+    size_t const count,
+    ionized_pool * const pool,
+    size_t const producer
+);
+
+#endif /* IONIZED_PREFAULT_H__ */
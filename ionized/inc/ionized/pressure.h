@@ -0,0 +1,177 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Memory pressure monitor of the daemon.
+ * \date        10/24/2026 03:22:08 PM
+ * \file        pressure.h
+ * \version     1.0
+ *
+ * Buffers of idle queues and speculative growth keep memory which the host
+ * may need more, and the kernel resolves that by killing someone, often a
+ * consumer of the daemon. The monitor registers a pressure stall trigger:
+ * the kernel wakes it once tasks stall on memory longer than the threshold
+ * within the window. For the next window the daemon is under pressure and
+ * sheds memory: elastic queues don't grow, they retire their surplus at
+ * once and return pages of free buffers. Each of these is counted by the
+ * monitor, next to the number of pressure events.
+ *
+ * The trigger file is /proc/pressure/memory for the whole system, or the
+ * memory.pressure file of a cgroup v2 to watch the daemon's container.
+ **/
+
+#ifndef IONIZED_PRESSURE_H__
+# define IONIZED_PRESSURE_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stdbool.h> /* bool */
+# include <stdint.h> /* uint32_t, uint64_t */
+
+/**
+ * \brief Default trigger file, covering the whole system.
+ */
+# define IONIZED_PRESSURE_PATH "/proc/pressure/memory"
+
+/**
+ * \brief Default stall time triggering the monitor, in us.
+ */
+# define IONIZED_PRESSURE_STALL 100000U
+
+/**
+ * \brief Default window of the trigger, in us.
+ */
+# define IONIZED_PRESSURE_WINDOW 1000000U
+
+typedef struct ionized_pressure_struct ionized_pressure;
+
+/**
+ * \brief Trigger of the monitor.
+ *
+ * Zeroes and NULL select defaults. The kernel takes windows from 500 ms to
+ * 10 s, and unprivileged processes only multiples of 2 s.
+ */
+typedef struct
+{
+    char const * path; /** Pressure file of the system or of a cgroup. */
+    uint32_t stall; /** Time tasks stall in the window, in us. */
+    uint32_t window; /** Time window, in us. */
+}
+ionized_pressure_policy;
+
+/**
+ * \brief Ways of shedding memory under pressure.
+ */
+typedef enum
+{
+    /** Buffers not allocated, growth of elastic queues was refused. */
+    IONIZED_PRESSURE_REJECTED,
+    /** Buffers retired from elastic queues before they were idle. */
+    IONIZED_PRESSURE_SHRUNK,
+    /** Queues which returned pages of their free buffers. */
+    IONIZED_PRESSURE_TRIMMED
+}
+ionized_pressure_action;
+
+/**
+ * \brief Tells whether the daemon is under memory pressure.
+ * \param self Monitor on which we'll operate.
+ * \return True within a window from the last trigger, false for invalid
+ *         monitor.
+ */
+typedef bool ( * ionized_pressure_active_func )(
+    ionized_pressure const * const self
+);
+
+/**
+ * \brief Records memory shed under pressure.
+ * \param self Monitor on which we'll operate.
+ * \param action What was done.
+ * \param count How many times, or to how many buffers.
+ * \return Zero on success, else error code.
+ *
+ * Safe to call from any thread.
+ * Possible error codes:
+ * 1. EINVAL - invalid monitor or action given.
+ */
+typedef ionize_status ( * ionized_pressure_shed_func )(
+    ionized_pressure * const self,
+    ionized_pressure_action const action,
+    uint64_t const count
+);
+
+/**
+ * \brief Counters of the monitor.
+ */
+typedef struct
+{
+    uint64_t events; /** Triggers fired by the kernel. */
+    uint64_t rejected; /** Buffers not allocated due to pressure. */
+    uint64_t shrunk; /** Buffers retired due to pressure. */
+    uint64_t trimmed; /** Queues trimmed due to pressure. */
+    bool active; /** Whether the daemon is under pressure now. */
+}
+ionized_pressure_stats;
+
+/**
+ * \brief Reads counters of the monitor.
+ * \param self Monitor on which we'll operate.
+ * \return Counters, all zeroes for invalid monitor.
+ */
+typedef ionized_pressure_stats ( * ionized_pressure_stats_func )(
+    ionized_pressure const * const self
+);
+
+/**
+ * \brief Opaque type holding internal monitor state.
+ */
+typedef struct ionized_pressure_state_struct ionized_pressure_state;
+
+/**
+ * \brief Representation of the monitor.
+ */
+struct ionized_pressure_struct
+{
+    ionized_pressure_state * state; /** Internal state. */
+    ionized_pressure_active_func active; /** Tells if under pressure. */
+    ionized_pressure_shed_func shed; /** Records memory shed. */
+    ionized_pressure_stats_func stats; /** Reads counters. */
+};
+
+/**
+ * \brief Declaration of type returned by ionized_pressure_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_pressure pressure; /** Monitor object, valid on success. */
+}
+ionized_pressure_setup_result;
+
+/**
+ * \brief Registers the trigger and starts a thread waiting for it.
+ * \param policy Trigger of the monitor.
+ * \return Structure containing error code and monitor object.
+ *
+ * Possible error codes:
+ * 1. EINVAL - stall longer than window, or window out of the range above,
+ *    or the kernel refused the trigger;
+ * 2. ENOENT - the kernel doesn't track pressure, or no such cgroup;
+ * 3. ENOMEM - couldn't allocate memory for monitor state;
+ * 4. EIO - the stop event couldn't be created;
+ * 5. codes set by open and write, notably EPERM for unprivileged windows;
+ * 6. codes returned by pthread_create.
+ */
+ionized_pressure_setup_result ionized_pressure_setup(
+    ionized_pressure_policy const policy
+);
+
+/**
+ * \brief Stops the thread and destroys the monitor.
+ * \param pressure Monitor to destroy.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid monitor given;
+ * 2. EIO - the thread couldn't be joined or descriptors closed.
+ */
+ionize_status ionized_pressure_cleanup( ionized_pressure * const pressure );
+
+#endif /* IONIZED_PRESSURE_H__ */
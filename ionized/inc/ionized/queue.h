@@ -0,0 +1,831 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Circular queue of memory buffers, as kept by ionized.
+ * \date        10/19/2026 02:05:13 PM
+ * \file        queue.h
+ * \version     1.0
+ *
+ * This is the daemon's side of plasma. Each queue is identified by its uid
+ * and holds buffers which cycle through states: free buffers get locked for
+ * writing, committed buffers become readable, readable buffers get locked for
+ * reading and become free again after the reader unlocks them. The queue can
+ * grow and shrink while clients hold locks on its buffers.
+ * All methods are thread-safe.
+ **/
+
+#ifndef IONIZED_QUEUE_H__
+# define IONIZED_QUEUE_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <ionized/latency.h> /* ionized_latency_snapshot_result */
+# include <ionized/pool.h> /* ionized_pool */
+# include <ionized/quota.h> /* ionized_quota */
+# include <plasma/config.h> /* plasma_config */
+# include <plasma/properties.h> /* plasma_properties */
+# include <plasma/tag.h> /* plasma_tag */
+# include <plasma/watermark.h> /* plasma_watermark */
+# include <stdbool.h> /* bool */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint32_t, uint64_t */
+
+/**
+ * \brief Forward declaration of the queue object.
+ */
+typedef struct ionized_queue_struct ionized_queue;
+
+/**
+ * \brief Representation of type returned by lock methods.
+ *
+ * The hold identifies the lock in later calls to commit and unlock.
+ * Clients don't share daemon's address space, so they get the descriptor
+ * of the buffer memory and offset of data in it.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    uint64_t hold; /** Identifier of the lock. */
+    void * data; /** Pointer to buffer data, in daemon's address space. */
+    size_t size; /** Size of data, committed length for readers. */
+    int fd; /** Descriptor of memory backing the buffer. */
+    size_t offset; /** Offset of data in memory backing the buffer. */
+    uint64_t sequence; /** Commit sequence number, zero for writers. */
+}
+ionized_queue_lock;
+
+/**
+ * \brief Sets configuration of the queue.
+ * \param self Queue on which we'll operate.
+ * \param config New configuration.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. EBUSY - queue already has buffers;
+ * 3. codes returned by plasma_config_validator.
+ */
+typedef ionize_status ( * ionized_queue_configure_func )(
+    ionized_queue * const self,
+    plasma_config const config
+);
+
+/**
+ * \brief Appends buffers to the queue.
+ * \param self Queue on which we'll operate.
+ * \param client Identifier of the client charged for the buffers.
+ * \param properties Array of buffer properties.
+ * \param length Length of properties array.
+ * \param flags Bitwise or of ionized_buffer_flag values, added to backing.
+ * \return Zero on success, else error code.
+ * \see ionized_buffer_setup
+ * \see ionized_queue_offload_func
+ * \see ionized_quota
+ *
+ * Either all buffers are added or none is. If the queue has a quota object,
+ * memory of the buffers is charged to the queue's uid and to the client, and
+ * refunded when buffers are retired. Buffers populated by the pool are added
+ * at once, but writers get them only once the pool is done, the call doesn't
+ * wait for it. If populating them fails, they're retired and it's logged.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue or properties given;
+ * 2. ENOTSUP - flags contain unknown values;
+ * 3. ENOMEM - memory for queue bookkeeping couldn't be allocated;
+ * 4. EAGAIN - the queue was configured with another header meanwhile;
+ * 5. codes returned by ionized_buffer_setup, and by ionized_prefault and
+ *    ionized_buffer_lock when the queue has no pool;
+ * 6. codes returned by quota's charge method, notably EDQUOT.
+ */
+typedef ionize_status ( * ionized_queue_allocate_func )(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const * const properties,
+    size_t const length,
+    uint32_t const flags
+);
+
+/**
+ * \brief Sets options of memory backing buffers allocated from now on.
+ * \param self Queue on which we'll operate.
+ * \param flags Bitwise or of ionized_buffer_flag values.
+ * \return Zero on success, else error code.
+ * \see ionized_buffer_flag
+ *
+ * Buffers allocated already keep their backing.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOTSUP - flags contain unknown values.
+ */
+typedef ionize_status ( * ionized_queue_backing_func )(
+    ionized_queue * const self,
+    uint32_t const flags
+);
+
+/**
+ * \brief Lets workers of the pool prefault buffers allocated from now on.
+ * \param self Queue on which we'll operate.
+ * \param pool Pool of workers, NULL prefaults on the allocating thread.
+ * \param producer Deque of the pool used by the thread allocating buffers.
+ * \return Zero on success, else error code.
+ * \see ionized_prefault
+ *
+ * Buffers to prefault or lock are mapped first, then their pages are
+ * populated by all workers at once, and only then locked, one by one.
+ * Allocating a gigabyte of locked memory takes a fraction of the time, and
+ * none of it on the allocating thread, which only maps the buffers. If the
+ * deque of the producer is full, the allocating thread populates them.
+ * Queues wait for buffers being populated when cleaned up.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_offload_func )(
+    ionized_queue * const self,
+    ionized_pool * const pool,
+    size_t const producer
+);
+
+/**
+ * \brief Retires buffers from the queue.
+ * \param self Queue on which we'll operate.
+ * \param length Number of buffers to retire.
+ * \return Zero on success, else error code.
+ *
+ * Free buffers are retired at once and their memory is returned to the
+ * system. If there are not enough free buffers, the remaining ones are
+ * retired as soon as readers consume them, without blocking anyone.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ERANGE - queue has fewer buffers than requested, nothing is retired.
+ */
+typedef ionize_status ( * ionized_queue_shrink_func )(
+    ionized_queue * const self,
+    size_t const length
+);
+
+/**
+ * \brief Declaration of type returned by ionized_queue_prune_func.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    size_t count; /** Number of buffers retired. */
+}
+ionized_queue_prune_result;
+
+/**
+ * \brief Retires free buffers which weren't needed for a while.
+ * \param self Queue on which we'll operate.
+ * \param length Most buffers to retire.
+ * \param idle Time each buffer has to stay free, in ns.
+ * \return Structure with error code and number of buffers retired.
+ * \see ionized_queue_shrink_func
+ *
+ * Unlike shrink, buffers freed recently or in use are kept, so fewer than
+ * length may be retired, and none of them later.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOMEM - no memory to note the buffers to destroy.
+ */
+typedef ionized_queue_prune_result ( * ionized_queue_prune_func )(
+    ionized_queue * const self,
+    size_t const length,
+    uint64_t const idle
+);
+
+/**
+ * \brief Locks a buffer for reading or writing.
+ * \param self Queue on which we'll operate.
+ * \param client Identifier of the requesting client.
+ * \param requested Properties of the buffer we want to acquire.
+ * \param blocking Whether to wait for a buffer to become available.
+ * \return Lock descriptor.
+ *
+ * Writers get the first free buffer following the last one locked for
+ * writing. Readers get the oldest committed buffer, or the most urgent one
+ * in queues configured with PLASMA_CONFIG_PRIORITY. While memory held by
+ * committed buffers not yet consumed is above the backpressure watermark,
+ * writers are treated as if there were no free buffers. In queues configured
+ * with PLASMA_CONFIG_OVERWRITE writers never wait: lacking a free buffer,
+ * they get the oldest committed buffer no reader has locked, which is counted
+ * as a drop. Backpressure doesn't apply to such queues.
+ * Queues configured with PLASMA_CONFIG_LATEST are triple buffers. Readers
+ * share the most recently committed buffer, which stays readable until
+ * a newer one is committed, so reading never consumes anything. Committing
+ * frees the superseded buffer at once, or when its last reader unlocks it.
+ * With three buffers, a single writer always finds one free, since at most
+ * one is being written, one is the latest and one is held by lagging readers;
+ * each further reader holding an older buffer needs one more.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOENT - no buffer in the queue matches requested properties;
+ * 3. EAGAIN - matching buffers are busy and blocking is false;
+ * 4. codes returned by plasma_properties_validator.
+ */
+typedef ionized_queue_lock ( * ionized_queue_lock_func )(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested,
+    bool const blocking
+);
+
+/**
+ * \brief Locks buffer retained for replay.
+ * \param self Queue on which we'll operate.
+ * \param client Identifier of the requesting client.
+ * \param requested Properties of the buffer we want to acquire.
+ * \param sequence Lowest commit sequence number the caller wants.
+ * \return Lock descriptor, released with unlock.
+ * \see ionized_queue_retention_func
+ *
+ * Locks consumed buffer, still covered by retention policy, with the lowest
+ * sequence number not less than requested one. Any number of clients may
+ * replay the same buffer. Replay never waits, since the buffer may be reused
+ * by writers at any moment it isn't locked.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOENT - no retained buffer matches;
+ * 3. codes returned by plasma_properties_validator.
+ */
+typedef ionized_queue_lock ( * ionized_queue_replay_lock_func )(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested,
+    uint64_t const sequence
+);
+
+/**
+ * \brief Locks snapshot of the most recently committed buffer.
+ * \param self Queue on which we'll operate.
+ * \param client Identifier of the requesting client.
+ * \param requested Properties of the buffer we want to acquire.
+ * \return Lock descriptor, released with unlock.
+ *
+ * Returns the buffer holding the newest committed contents, whether it's
+ * still unread, being read or already consumed. The buffer isn't consumed,
+ * other readers may take it as usual. While any snapshot of the buffer is
+ * locked, writers skip it and take other free buffers instead, so the
+ * contents stay intact however long the snapshot is read. Writers wait only
+ * if all free buffers are pinned, one spare buffer per concurrent snapshot
+ * avoids that. Buffers published by other queues aren't snapshotted. Each
+ * snapshot gets its own hold, so releasing one twice doesn't unpin another.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOENT - no buffer in the queue matches requested properties;
+ * 3. EAGAIN - no matching buffer was committed yet;
+ * 4. ENOMEM - no memory to record the snapshot;
+ * 5. codes returned by plasma_properties_validator.
+ */
+typedef ionized_queue_lock ( * ionized_queue_snapshot_lock_func )(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested
+);
+
+/**
+ * \brief Commits buffer locked for writing, making it readable.
+ * \param self Queue on which we'll operate.
+ * \param hold Identifier of the write lock.
+ * \param length Number of bytes written.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. EPERM - hold doesn't identify a write lock;
+ * 3. ERANGE - length is greater than size of the buffer;
+ * 4. ETIMEDOUT - the lock was revoked when its lease expired.
+ * Holds of appends are committed the same way, with the reserved length.
+ */
+typedef ionize_status ( * ionized_queue_commit_func )(
+    ionized_queue * const self,
+    uint64_t const hold,
+    size_t const length
+);
+
+/**
+ * \brief Tags buffer locked for writing.
+ * \param self Queue on which we'll operate.
+ * \param hold Identifier of the write lock.
+ * \param tag Urgency of the buffer, used once it's committed.
+ * \return Zero on success, else error code.
+ * \see plasma_tag
+ *
+ * Queues configured with PLASMA_CONFIG_PRIORITY keep committed buffers in
+ * a binary heap ordered by tags, so readers get the most urgent one in
+ * logarithmic time. Other queues ignore tags.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. EPERM - hold doesn't identify a write lock;
+ * 3. ETIMEDOUT - the lock was revoked when its lease expired.
+ */
+typedef ionize_status ( * ionized_queue_tag_func )(
+    ionized_queue * const self,
+    uint64_t const hold,
+    plasma_tag const tag
+);
+
+/**
+ * \brief Reserves bytes in buffer shared by producers appending to queue.
+ * \param self Queue on which we'll operate.
+ * \param client Identifier of the client reserving the bytes.
+ * \param length Number of bytes to reserve.
+ * \return Lock descriptor of the reserved range, finished with commit.
+ *
+ * Producers append small records to the same buffer instead of locking one
+ * buffer each. Reservations are a single atomic addition on the offset of
+ * the buffer, so they don't contend on the queue mutex. The buffer becomes
+ * readable once it's full and every reservation in it is committed, or once
+ * it's older than the flush timeout. The range is at data and offset of the
+ * returned lock, commit it with the whole reserved length. Reservations
+ * never block, call read_lock on a full queue to wait for space.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given or zero length;
+ * 2. ENOENT - no buffer in the queue can hold length bytes;
+ * 3. ERANGE - length exceeds capacity of the buffer taking appends;
+ * 4. EAGAIN - no free buffer to append to;
+ * 5. ENOMEM - no memory to track the buffer.
+ */
+typedef ionized_queue_lock ( * ionized_queue_append_func )(
+    ionized_queue * const self,
+    uint32_t const client,
+    size_t const length
+);
+
+/**
+ * \brief Seals buffer taking appends, if it's older than the flush timeout.
+ * \param self Queue on which we'll operate.
+ * \param force Seals the buffer regardless of its age.
+ * \return Zero on success, else error code.
+ *
+ * Appends and commits check the timeout themselves, this is for periodic
+ * timers when producers go quiet, and shutdown. The buffer is readable once
+ * reservations made before sealing are committed.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_flush_func )(
+    ionized_queue * const self,
+    bool const force
+);
+
+/**
+ * \brief Sets age at which buffer taking appends is sealed.
+ * \param self Queue on which we'll operate.
+ * \param timeout Age in nanoseconds, zero seals buffers only when full.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_flush_timeout_func )(
+    ionized_queue * const self,
+    uint64_t const timeout
+);
+
+/**
+ * \brief Releases a lock.
+ * \param self Queue on which we'll operate.
+ * \param hold Identifier of the lock.
+ * \return Zero on success, else error code.
+ *
+ * Releasing write lock commits the whole buffer.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. EPERM - hold doesn't identify a lock, or it was released already;
+ * 3. ETIMEDOUT - the lock was revoked when its lease expired, the buffer
+ *    was discarded or consumed already.
+ * Holds of replay and snapshot locks are released the same way.
+ */
+typedef ionize_status ( * ionized_queue_unlock_func )(
+    ionized_queue * const self,
+    uint64_t const hold
+);
+
+/**
+ * \brief Releases a lock of a client which is gone.
+ * \param self Queue on which we'll operate.
+ * \param hold Identifier of the lock.
+ * \param length Length of the reservation for holds of appends.
+ * \return Zero on success, else error code.
+ * \see ionized_reaper
+ *
+ * Unlike unlock, buffers locked for writing are freed without committing,
+ * readers never see what the client had written so far. Reservations of
+ * appends are committed, so data of other producers in the same buffer
+ * isn't held back; the range holds whatever the client managed to write.
+ * Other locks are released as by unlock.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. EPERM - hold doesn't identify a lock;
+ * 3. ETIMEDOUT - the lock was revoked when its lease expired.
+ */
+typedef ionize_status ( * ionized_queue_abandon_func )(
+    ionized_queue * const self,
+    uint64_t const hold,
+    size_t const length
+);
+
+/**
+ * \brief Sets lease of read and write locks.
+ * \param self Queue on which we'll operate.
+ * \param lease Time in nanoseconds a lock may be held, zero disables leases.
+ * \return Zero on success, else error code.
+ * \see ionized_queue_expire_func
+ *
+ * A client stuck on a buffer would otherwise starve writers of the whole
+ * queue. Locks held longer than the lease are revoked: writes are discarded
+ * as if abandoned, buffers being read are consumed. The client's own holds
+ * fail with ETIMEDOUT afterwards, so only the stuck client is affected.
+ * Buffers taking appends, snapshots and replays aren't leased. The lease
+ * applies to locks taken before it was set too. Readers sharing a buffer
+ * share one hold, so they share its lease too: it starts with the first
+ * reader and, once over, is revoked for all of them, even for readers that
+ * joined late. Queues serving the latest buffer to slow and fast readers
+ * alike want a lease long enough for the slowest one.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_lease_func )(
+    ionized_queue * const self,
+    uint64_t const lease
+);
+
+/**
+ * \brief Revokes locks which outlived their lease.
+ * \param self Queue on which we'll operate.
+ * \return Zero on success, else error code.
+ *
+ * Meant for periodic timers, shards call it every tick. Each revocation is
+ * logged and counted in statistics.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_expire_func )(
+    ionized_queue * const self
+);
+
+/**
+ * \brief Copies latency histograms of the queue.
+ * \param self Queue on which we'll operate.
+ * \return Copy of histograms, all zeroes for invalid queue.
+ * \see ionized_latency_snapshot
+ */
+typedef ionized_latency_snapshot_result ( * ionized_queue_latency_func )(
+    ionized_queue * const self
+);
+
+/**
+ * \brief Representation of queue usage statistics.
+ *
+ * Counters only grow, other values describe the queue at the moment of the
+ * call, with the exception of free_low, which covers the time since the last
+ * call that reset statistics.
+ */
+typedef struct
+{
+    size_t buffers; /** Buffers holding memory, including ones retiring. */
+    size_t populating; /** Buffers not yet populated by the pool. */
+    size_t bytes; /** Memory held by buffers, in bytes. */
+    size_t free; /** Buffers available for writing. */
+    size_t free_low; /** Lowest number of free buffers since reset. */
+    uint64_t idle; /** Longest time any free buffer stays free, in ns. */
+    uint64_t write_waits; /** Write locks which had to wait. */
+    uint64_t write_eagains; /** Write locks which failed with EAGAIN. */
+    uint64_t write_backpressured; /** Write locks held back by readers. */
+    uint64_t drops; /** Unread buffers overwritten by writers. */
+    uint64_t revoked; /** Locks revoked after their lease expired. */
+    size_t cold; /** Pages of buffers which fault on first touch. */
+    uint64_t scrubbed; /** Free buffers zeroed by sweeps. */
+    uint64_t scrubbed_inline; /** Buffers zeroed by writers taking them. */
+    uint64_t reclaimed; /** Idle buffers whose pages were returned. */
+    plasma_properties properties; /** Properties of last allocation. */
+}
+ionized_queue_stats;
+
+/**
+ * \brief Reads usage statistics of the queue.
+ * \param self Queue on which we'll operate.
+ * \param reset Whether to start new period for free_low.
+ * \return Statistics, all zeroes for invalid queue.
+ * \see ionized_queue_stats
+ * \see ionized_buffer_cold
+ *
+ * Counting cold pages asks the kernel about every page of the queue, so
+ * the call takes longer the more memory the queue holds. It's done after
+ * the queue is unlocked, so it doesn't hold back writers and readers, but
+ * buffers retired meanwhile may be miscounted. Without memory for the list
+ * of buffers, cold is zero.
+ */
+typedef ionized_queue_stats ( * ionized_queue_stats_func )(
+    ionized_queue * const self,
+    bool const reset
+);
+
+/**
+ * \brief Sets backpressure watermark of the queue.
+ * \param self Queue on which we'll operate.
+ * \param watermark Memory of unconsumed buffers, in bytes, zero disables.
+ * \return Zero on success, else error code.
+ *
+ * Once committed buffers that weren't consumed yet hold at least watermark
+ * bytes, write locks wait (or fail with EAGAIN) until readers catch up, even
+ * if there are free buffers. Write locks held back this way aren't counted
+ * as waits or EAGAINs in statistics, since adding buffers wouldn't help.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_backpressure_func )(
+    ionized_queue * const self,
+    size_t const watermark
+);
+
+/**
+ * \brief Retention policy keeping consumed buffers available for replay.
+ *
+ * A consumed buffer is retained if it's among the last count committed ones
+ * or it was committed less than age nanoseconds ago. Zero disables either
+ * condition. Retention never holds writers back: they take free buffers
+ * first and, when there are none, reuse the oldest retained buffer not being
+ * replayed, so the policy is best effort under load.
+ */
+typedef struct
+{
+    uint64_t count; /** Number of latest commits retained. */
+    uint64_t age; /** Time for which commits are retained, in ns. */
+}
+ionized_queue_retention;
+
+/**
+ * \brief Sets retention policy of the queue.
+ * \param self Queue on which we'll operate.
+ * \param retention New policy, applies to buffers consumed from now on.
+ * \return Zero on success, else error code.
+ * \see ionized_queue_retention
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_retention_func )(
+    ionized_queue * const self,
+    ionized_queue_retention const retention
+);
+
+/**
+ * \brief Policy for memory of free buffers.
+ *
+ * Free buffers idle for at least idle nanoseconds have their pages returned
+ * to the system, so bursty queues don't keep the memory of their last peak
+ * resident. The next writer of such buffer takes a fault per page. With
+ * scrub set, buffers are zeroed before another write, so no writer sees
+ * data of earlier ones. Both are done by the reclaim method, away from the
+ * threads locking buffers; writers zero a buffer themselves only if they
+ * take it before that. Zero idle and false scrub disable the policy.
+ * Buffers allocated with IONIZED_BUFFER_PREFAULT or IONIZED_BUFFER_MLOCK
+ * keep their pages, scrubbing only zeroes them.
+ */
+typedef struct
+{
+    uint64_t idle; /** Time after which pages of free buffer are returned. */
+    bool scrub; /** Whether buffers are zeroed before they're reused. */
+}
+ionized_queue_reclamation;
+
+/**
+ * \brief Sets policy for memory of free buffers.
+ * \param self Queue on which we'll operate.
+ * \param reclamation New policy, applies to buffers freed before too.
+ * \return Zero on success, else error code.
+ * \see ionized_queue_reclamation
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given.
+ */
+typedef ionize_status ( * ionized_queue_reclamation_func )(
+    ionized_queue * const self,
+    ionized_queue_reclamation const reclamation
+);
+
+/**
+ * \brief Zeroes and returns pages of free buffers, as the policy says.
+ * \param self Queue on which we'll operate.
+ * \return Zero on success, else error code.
+ * \see ionized_queue_offload_func
+ *
+ * Meant for periodic timers, shards call it every tick. Buffers are swept
+ * by a task of the queue's pool, or by the caller if there is no pool, and
+ * writers skip them meanwhile. The call doesn't wait for the task.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOMEM - no memory for the sweep.
+ */
+typedef ionize_status ( * ionized_queue_reclaim_func )(
+    ionized_queue * const self
+);
+
+/**
+ * \brief Returns pages of all free buffers, whatever their idle time.
+ * \param self Queue on which we'll operate.
+ * \return Zero on success, else error code.
+ * \see ionized_queue_reclaim_func
+ *
+ * Meant for memory pressure, when every page counts. Works as a sweep of
+ * the reclaim method does, scrubbing too if the policy says so. Pages of
+ * prefaulted or locked buffers aren't returned, retire those instead.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOMEM - no memory for the sweep.
+ */
+typedef ionize_status ( * ionized_queue_trim_func )(
+    ionized_queue * const self
+);
+
+/**
+ * \brief Representation of type returned by subscribe method.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    int fd; /** Eventfd signalled on crossings, -1 on error. */
+}
+ionized_queue_subscription;
+
+/**
+ * \brief Subscribes to crossings of occupancy watermark.
+ * \param self Queue on which we'll operate.
+ * \param watermark Watermark to watch.
+ * \return Structure with error code and non-blocking eventfd.
+ * \see plasma_subscribe_func
+ *
+ * The eventfd is incremented each time the watermark condition changes from
+ * false to true, so pollers wake up on edges, not while the condition holds.
+ * If the condition already holds, the eventfd is incremented at once.
+ * Percentages are relative to number of buffers not scheduled for retiring.
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOMEM - memory for subscription couldn't be allocated;
+ * 3. codes returned by plasma_watermark_validator and eventfd.
+ */
+typedef ionized_queue_subscription ( * ionized_queue_subscribe_func )(
+    ionized_queue * const self,
+    plasma_watermark const watermark
+);
+
+/**
+ * \brief Cancels subscription, closing its eventfd.
+ * \param self Queue on which we'll operate.
+ * \param fd Eventfd returned by subscribe.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. ENOENT - fd isn't a subscription of the queue.
+ */
+typedef ionize_status ( * ionized_queue_unsubscribe_func )(
+    ionized_queue * const self,
+    int const fd
+);
+
+/**
+ * \brief Opaque type holding internal queue state.
+ */
+typedef struct ionized_queue_state_struct ionized_queue_state;
+
+/**
+ * \brief Declaration of the queue object.
+ */
+struct ionized_queue_struct
+{
+    ionized_queue_state * state; /** Object's state. */
+    ionized_queue_configure_func configure; /** Sets configuration. */
+    ionized_queue_allocate_func allocate; /** Appends buffers. */
+    ionized_queue_backing_func backing; /** Sets backing of new buffers. */
+    ionized_queue_offload_func offload; /** Sets pool prefaulting buffers. */
+    ionized_queue_shrink_func shrink; /** Retires buffers. */
+    ionized_queue_prune_func prune; /** Retires idle free buffers. */
+    ionized_queue_lock_func read_lock; /** Locks buffer for reading. */
+    ionized_queue_lock_func write_lock; /** Locks buffer for writing. */
+    ionized_queue_replay_lock_func replay_lock; /** Locks retained buffer. */
+    ionized_queue_snapshot_lock_func snapshot_lock; /** Pins latest data. */
+    ionized_queue_commit_func commit; /** Commits written buffer. */
+    ionized_queue_tag_func tag; /** Tags written buffer. */
+    ionized_queue_append_func append; /** Reserves bytes to append. */
+    ionized_queue_flush_func flush; /** Seals buffer taking appends. */
+    ionized_queue_flush_timeout_func flush_timeout; /** Sets flush age. */
+    ionized_queue_unlock_func unlock; /** Releases a lock. */
+    ionized_queue_abandon_func abandon; /** Releases lock of dead client. */
+    ionized_queue_lease_func lease; /** Sets lease of locks. */
+    ionized_queue_expire_func expire; /** Revokes locks past their lease. */
+    ionized_queue_latency_func latency; /** Reads latency histograms. */
+    ionized_queue_stats_func stats; /** Reads usage statistics. */
+    ionized_queue_backpressure_func backpressure; /** Sets watermark. */
+    ionized_queue_subscribe_func subscribe; /** Watches occupancy. */
+    ionized_queue_unsubscribe_func unsubscribe; /** Stops watching. */
+    ionized_queue_retention_func retention; /** Sets retention policy. */
+    ionized_queue_reclamation_func reclamation; /** Sets memory policy. */
+    ionized_queue_reclaim_func reclaim; /** Sweeps free buffers. */
+    ionized_queue_trim_func trim; /** Returns pages of free buffers. */
+};
+
+/**
+ * \brief Moves buffer locked for reading into another queue.
+ * \param source Queue holding the read lock.
+ * \param hold Identifier of the read lock.
+ * \param target Queue receiving the buffer.
+ * \param length Number of bytes readable in target queue.
+ * \return Zero on success, else error code.
+ * \see plasma_transfer_func
+ *
+ * Memory isn't copied: the buffer becomes committed readable buffer of the
+ * target, while a free buffer of the target takes its place in the source,
+ * so clients mapping either queue keep using the same descriptors. Buffers
+ * keep their owners, quota charges follow the buffers to the uid of their
+ * new queue. Except for EINVAL, the read lock is released even on failure,
+ * the buffer is then consumed as after unlock.
+ * Possible error codes:
+ * 1. EINVAL - invalid queues given, queues are the same or only one of them
+ *    reserves space for plasma_header;
+ * 2. EPERM - hold doesn't identify read lock, the lock is shared or the
+ *    buffer is snapshotted or published;
+ * 3. ERANGE - length is greater than size of the buffer;
+ * 4. EAGAIN - target has no free buffer;
+ * 5. codes returned by quota's charge method, notably EDQUOT.
+ */
+ionize_status ionized_queue_transfer(
+    ionized_queue * const source,
+    uint64_t const hold,
+    ionized_queue * const target,
+    size_t const length
+);
+
+/**
+ * \brief Commits buffer locked for writing into several queues at once.
+ * \param self Queue holding the write lock.
+ * \param hold Identifier of the write lock.
+ * \param targets Array of other queues receiving the buffer.
+ * \param count Length of targets array.
+ * \param length Number of bytes written.
+ * \return Zero on success, else error code.
+ * \warning Targets must be destroyed before the queue publishing to them.
+ *
+ * The buffer is committed in this queue as by commit, and the same memory
+ * becomes committed buffer of each target, without copying. Targets don't
+ * hold or get charged for the memory, they share a reference count with the
+ * buffer's slot here. The slot is reused only after readers of every queue
+ * consumed the buffer; until then writers here treat it as busy. Shared
+ * buffers are never dropped by overwriting queues nor transferred.
+ * If a target can't take the buffer, the rest still get it and the first
+ * error is returned.
+ * Possible error codes:
+ * 1. EINVAL - invalid queues given, a target is this queue or only one of
+ *    the queues reserves space for plasma_header;
+ * 2. EPERM - hold doesn't identify a write lock;
+ * 3. ERANGE - length is greater than size of the buffer;
+ * 4. ENOMEM - memory for bookkeeping couldn't be allocated.
+ */
+ionize_status ionized_queue_publish(
+    ionized_queue * const self,
+    uint64_t const hold,
+    ionized_queue * const * const targets,
+    size_t const count,
+    size_t const length
+);
+
+/**
+ * \brief Declaration of type returned by ionized_queue_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_queue queue; /** Queue object. */
+}
+ionized_queue_setup_result;
+
+/**
+ * \brief Creates an empty queue.
+ * \param uid Unique identifier of the queue.
+ * \param sampling Latency sampling, as in ionized_latency_init.
+ * \param quota Budgets charged for buffers, NULL if unlimited.
+ * \return Structure containing error code and queue object.
+ *
+ * Possible error codes:
+ * 1. ENOMEM - couldn't allocate memory for queue state;
+ * 2. EIO - synchronization primitives couldn't be initialized;
+ * 3. codes returned by ionized_latency_init.
+ */
+ionized_queue_setup_result ionized_queue_setup(
+    uint32_t const uid,
+    uint32_t const sampling,
+    ionized_quota * const quota
+);
+
+/**
+ * \brief Destroys the queue with all its buffers.
+ * \param queue Queue to destroy.
+ * \return Zero on success, else error code.
+ * \warning No client may use the queue during or after cleanup.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid queue given;
+ * 2. EIO - destroying a buffer or synchronization primitives failed.
+ * Descriptors of remaining subscriptions are closed as well.
+ */
+ionize_status ionized_queue_cleanup( ionized_queue * const queue );
+
+#endif /* IONIZED_QUEUE_H__ */
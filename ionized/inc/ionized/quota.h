@@ -0,0 +1,169 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Memory budgets of queues and clients.
+ * \date        10/20/2026 11:05:49 AM
+ * \file        quota.h
+ * \version     1.0
+ *
+ * The daemon keeps one ionized_quota object. Every buffer allocation is
+ * charged to the uid of the queue and to the client requesting it, and is
+ * refunded when the buffer is retired. Allocation exceeding either budget
+ * fails with EDQUOT, long before the host would run out of memory, so one
+ * runaway producer can't starve other pipelines.
+ **/
+
+#ifndef IONIZED_QUOTA_H__
+# define IONIZED_QUOTA_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Client identifier used for memory allocated by the daemon itself.
+ *
+ * Such memory is charged only to the uid of the queue.
+ */
+# define IONIZED_QUOTA_DAEMON 0U
+
+/**
+ * \brief Kinds of budgets.
+ */
+typedef enum
+{
+    IONIZED_QUOTA_UID, /** Budget of a queue. */
+    IONIZED_QUOTA_CLIENT /** Budget of a client, over all its queues. */
+}
+ionized_quota_kind;
+
+/**
+ * \brief Forward declaration of the quota object.
+ */
+typedef struct ionized_quota_struct ionized_quota;
+
+/**
+ * \brief Sets budget of a queue or client.
+ * \param self Quota object on which we'll operate.
+ * \param kind Kind of budget.
+ * \param id Uid of the queue or identifier of the client.
+ * \param limit Budget in bytes, zero restores the default.
+ * \return Zero on success, else error code.
+ *
+ * Lowering the budget below current usage doesn't retire anything, but
+ * following allocations will fail.
+ * Possible error codes:
+ * 1. EINVAL - invalid self or kind given;
+ * 2. ENOMEM - couldn't allocate memory for bookkeeping;
+ * 3. codes returned by ionize_mutex lock and unlock methods.
+ */
+typedef ionize_status ( * ionized_quota_set_func )(
+    ionized_quota * const self,
+    ionized_quota_kind const kind,
+    uint32_t const id,
+    size_t const limit
+);
+
+/**
+ * \brief Charges or refunds memory.
+ * \param self Quota object on which we'll operate.
+ * \param uid Uid of the queue.
+ * \param client Identifier of the client.
+ * \param bytes Amount of memory.
+ * \return Zero on success, else error code.
+ *
+ * Charge affects both budgets or none of them.
+ * Possible error codes:
+ * 1. EINVAL - invalid self given;
+ * 2. EDQUOT - charge would exceed one of the budgets;
+ * 3. ENOMEM - couldn't allocate memory for bookkeeping;
+ * 4. codes returned by ionize_mutex lock and unlock methods.
+ */
+typedef ionize_status ( * ionized_quota_charge_func )(
+    ionized_quota * const self,
+    uint32_t const uid,
+    uint32_t const client,
+    size_t const bytes
+);
+
+/**
+ * \brief Declaration of type returned by usage method.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    size_t used; /** Memory charged, in bytes. */
+    size_t limit; /** Budget, zero if unlimited. */
+}
+ionized_quota_usage;
+
+/**
+ * \brief Reads usage of a budget.
+ * \param self Quota object on which we'll operate.
+ * \param kind Kind of budget.
+ * \param id Uid of the queue or identifier of the client.
+ * \return Structure with error code, usage and limit.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid self or kind given;
+ * 2. codes returned by ionize_mutex lock and unlock methods.
+ */
+typedef ionized_quota_usage ( * ionized_quota_usage_func )(
+    ionized_quota * const self,
+    ionized_quota_kind const kind,
+    uint32_t const id
+);
+
+/**
+ * \brief Opaque type holding internal quota state.
+ */
+typedef struct ionized_quota_state_struct ionized_quota_state;
+
+/**
+ * \brief Declaration of the quota object.
+ */
+struct ionized_quota_struct
+{
+    ionized_quota_state * state; /** Object's state. */
+    ionized_quota_set_func set; /** Sets a budget. */
+    ionized_quota_charge_func charge; /** Charges memory to budgets. */
+    ionized_quota_charge_func refund; /** Returns memory to budgets. */
+    ionized_quota_usage_func usage; /** Reads usage of a budget. */
+};
+
+/**
+ * \brief Declaration of type returned by ionized_quota_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_quota quota; /** Quota object. */
+}
+ionized_quota_setup_result;
+
+/**
+ * \brief Creates quota object.
+ * \param uid Default budget of each queue, zero for unlimited.
+ * \param client Default budget of each client, zero for unlimited.
+ * \return Structure containing error code and quota object.
+ *
+ * Possible error codes:
+ * 1. ENOMEM - couldn't allocate memory for quota state;
+ * 2. codes returned by ionize_mutex_setup.
+ */
+ionized_quota_setup_result ionized_quota_setup(
+    size_t const uid,
+    size_t const client
+);
+
+/**
+ * \brief Destroys quota object.
+ * \param quota Quota object to destroy.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid quota given;
+ * 2. codes returned by ionize_mutex_cleanup.
+ */
+ionize_status ionized_quota_cleanup( ionized_quota * const quota );
+
+#endif /* IONIZED_QUOTA_H__ */
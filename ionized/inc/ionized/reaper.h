@@ -0,0 +1,177 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Release of locks held by clients which died.
+ * \date        10/23/2026 09:12:30 AM
+ * \file        reaper.h
+ * \version     1.0
+ *
+ * A client process dying with a buffer locked would keep it forever, and
+ * writers would eventually block on the queue. Each shard keeps a reaper,
+ * which holds a pidfd of every connected client process and a table of the
+ * locks the client holds. The pidfds are watched by the shard's event loop,
+ * so the locks of a dead client are abandoned as soon as the loop wakes up,
+ * usually within microseconds of the exit.
+ **/
+
+#ifndef IONIZED_REAPER_H__
+# define IONIZED_REAPER_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <ionized/loop.h> /* ionized_loop */
+# include <ionized/queue.h> /* ionized_queue */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint32_t, uint64_t */
+# include <sys/types.h> /* pid_t */
+
+typedef struct ionized_reaper_struct ionized_reaper;
+
+/**
+ * \brief Starts tracking a client process.
+ * \param self Reaper on which we'll operate.
+ * \param client Identifier of the client, as passed to queues.
+ * \param pid Process of the client, from credentials of its connection.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid reaper given;
+ * 2. EEXIST - the client is tracked already;
+ * 3. ESRCH - the process is gone already;
+ * 4. ENOMEM - no memory to track the client;
+ * 5. codes set by pidfd_open and returned by the loop's watch method.
+ */
+typedef ionize_status ( * ionized_reaper_track_func )(
+    ionized_reaper * const self,
+    uint32_t const client,
+    pid_t const pid
+);
+
+/**
+ * \brief Records a lock taken by the client.
+ * \param self Reaper on which we'll operate.
+ * \param client Identifier of the client.
+ * \param queue Queue the lock belongs to.
+ * \param hold Identifier of the lock.
+ * \param length Reserved length for appends, else ignored.
+ * \return Zero on success, else error code.
+ * \see ionized_queue_abandon_func
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid reaper or queue given;
+ * 2. ENOENT - the client isn't tracked;
+ * 3. ENOMEM - no memory to record the lock.
+ */
+typedef ionize_status ( * ionized_reaper_hold_func )(
+    ionized_reaper * const self,
+    uint32_t const client,
+    ionized_queue * const queue,
+    uint64_t const hold,
+    size_t const length
+);
+
+/**
+ * \brief Forgets a lock the client released itself.
+ * \param self Reaper on which we'll operate.
+ * \param client Identifier of the client.
+ * \param queue Queue the lock belongs to.
+ * \param hold Identifier of the lock.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid reaper given;
+ * 2. ENOENT - the client isn't tracked or doesn't hold the lock.
+ */
+typedef ionize_status ( * ionized_reaper_release_func )(
+    ionized_reaper * const self,
+    uint32_t const client,
+    ionized_queue * const queue,
+    uint64_t const hold
+);
+
+/**
+ * \brief Stops tracking a client which disconnected.
+ * \param self Reaper on which we'll operate.
+ * \param client Identifier of the client.
+ * \return Zero on success, else error code.
+ *
+ * Locks still held are abandoned, nobody could release them anymore.
+ * Possible error codes:
+ * 1. EINVAL - invalid reaper given;
+ * 2. ENOENT - the client isn't tracked.
+ */
+typedef ionize_status ( * ionized_reaper_untrack_func )(
+    ionized_reaper * const self,
+    uint32_t const client
+);
+
+/**
+ * \brief Counters of the reaper.
+ */
+typedef struct
+{
+    uint64_t reaped; /** Clients found dead. */
+    uint64_t abandoned; /** Locks abandoned, of dead or disconnected ones. */
+    size_t tracked; /** Clients tracked now. */
+}
+ionized_reaper_stats;
+
+/**
+ * \brief Reads counters of the reaper.
+ * \param self Reaper on which we'll operate.
+ * \return Counters, all zeroes for invalid reaper.
+ */
+typedef ionized_reaper_stats ( * ionized_reaper_stats_func )(
+    ionized_reaper const * const self
+);
+
+/**
+ * \brief Opaque type holding internal reaper state.
+ */
+typedef struct ionized_reaper_state_struct ionized_reaper_state;
+
+/**
+ * \brief Representation of the reaper.
+ */
+struct ionized_reaper_struct
+{
+    ionized_reaper_state * state; /** Internal state. */
+    ionized_reaper_track_func track; /** Starts tracking client. */
+    ionized_reaper_hold_func hold; /** Records lock. */
+    ionized_reaper_release_func release; /** Forgets lock. */
+    ionized_reaper_untrack_func untrack; /** Stops tracking client. */
+    ionized_reaper_stats_func stats; /** Reads counters. */
+};
+
+/**
+ * \brief Declaration of type returned by ionized_reaper_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_reaper reaper; /** Reaper object, valid on success. */
+}
+ionized_reaper_setup_result;
+
+/**
+ * \brief Creates a reaper tracking no clients.
+ * \param loop Loop watching pidfds, the reaper is used on its thread only.
+ * \return Structure containing error code and reaper object.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid loop given;
+ * 2. ENOMEM - couldn't allocate memory for reaper state.
+ */
+ionized_reaper_setup_result ionized_reaper_setup( ionized_loop * const loop );
+
+/**
+ * \brief Destroys the reaper.
+ * \param reaper Reaper to destroy.
+ * \return Zero on success, else error code.
+ *
+ * Clients still tracked are forgotten, their locks are left as they are.
+ * Possible error codes:
+ * 1. EINVAL - invalid reaper given;
+ * 2. EIO - pidfds couldn't be closed.
+ */
+ionize_status ionized_reaper_cleanup( ionized_reaper * const reaper );
+
+#endif /* IONIZED_REAPER_H__ */
@@ -0,0 +1,189 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Shard of the daemon, owning a disjoint set of queues.
+ * \date        10/21/2026 04:05:51 PM
+ * \file        shard.h
+ * \version     1.0
+ *
+ * The daemon runs one shard per core. Each shard has a worker thread pinned
+ * to its core, an event loop serving clients connected to the shard's port,
+ * a reaper releasing locks of its clients which died, and the queues whose
+ * uids hash to it, see plasma_shard. Nothing is shared
+ * between shards except the quota, if the daemon passes the same one to all
+ * of them, so allocations and control messages scale with cores instead of
+ * queueing behind one lock.
+ **/
+
+#ifndef IONIZED_SHARD_H__
+# define IONIZED_SHARD_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <ionized/loop.h> /* ionized_loop */
+# include <ionized/queue.h> /* ionized_queue */
+# include <ionized/quota.h> /* ionized_quota */
+# include <ionized/reaper.h> /* ionized_reaper */
+# include <stddef.h> /* size_t */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Longest wait of the worker for clients, in milliseconds.
+ *
+ * Between waits the worker flushes appends of its queues and revokes locks
+ * past their lease, so this bounds how late flush timeouts and leases fire.
+ */
+# define IONIZED_SHARD_TICK 10
+
+typedef struct ionized_shard_struct ionized_shard;
+
+/**
+ * \brief Declaration of type returned by ionized_shard_queue_func.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_queue * queue; /** Queue owned by the shard, valid on success. */
+}
+ionized_shard_queue_result;
+
+/**
+ * \brief Finds queue owned by the shard, creating it on first use.
+ * \param self Shard on which we'll operate.
+ * \param uid Unique identifier of the queue.
+ * \return Structure with error code and pointer to the queue.
+ * \see plasma_shard
+ *
+ * Called by handlers on the worker thread, or before the shard is started.
+ * The queue lives until the shard is cleaned up.
+ * Possible error codes:
+ * 1. EINVAL - invalid shard given;
+ * 2. EXDEV - the uid hashes to another shard, the client connected to the
+ *    wrong port;
+ * 3. ENOMEM - no memory for the queue;
+ * 4. codes returned by ionized_queue_setup.
+ */
+typedef ionized_shard_queue_result ( * ionized_shard_queue_func )(
+    ionized_shard * const self,
+    uint32_t const uid
+);
+
+/**
+ * \brief Returns event loop of the shard.
+ * \param self Shard on which we'll operate.
+ * \return Loop serving clients of the shard, NULL for invalid shard.
+ *
+ * The transport watches its listening filament with it before the shard is
+ * started and accepted clients from the handlers, on the worker thread.
+ */
+typedef ionized_loop * ( * ionized_shard_loop_func )(
+    ionized_shard * const self
+);
+
+/**
+ * \brief Starts the worker thread, pinned to the core of the shard.
+ * \param self Shard on which we'll operate.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid shard given;
+ * 2. EBUSY - the worker is running already;
+ * 3. codes returned by pthread_attr_init, pthread_attr_setaffinity_np and
+ *    pthread_create, the worker isn't started then.
+ */
+typedef ionize_status ( * ionized_shard_start_func )(
+    ionized_shard * const self
+);
+
+/**
+ * \brief Stops the worker thread and waits for it to finish.
+ * \param self Shard on which we'll operate.
+ * \return Zero on success, else error code.
+ *
+ * The worker finishes its current run and flushes appends of all queues.
+ * Possible error codes:
+ * 1. EINVAL - invalid shard given;
+ * 2. ENOENT - the worker isn't running;
+ * 3. codes returned by the loop's wake method and pthread_join.
+ */
+typedef ionize_status ( * ionized_shard_stop_func )(
+    ionized_shard * const self
+);
+
+/**
+ * \brief Returns reaper of the shard.
+ * \param self Shard on which we'll operate.
+ * \return Reaper watching clients of the shard, NULL for invalid shard.
+ * \see ionized_reaper
+ *
+ * Handlers track each client accepted by the shard with it, then record
+ * every lock the client takes on the shard's queues and forget the ones it
+ * releases. Used on the worker thread only, as its pidfds are watched by
+ * the shard's loop.
+ */
+typedef ionized_reaper * ( * ionized_shard_reaper_func )(
+    ionized_shard * const self
+);
+
+/**
+ * \brief Opaque type holding internal shard state.
+ */
+typedef struct ionized_shard_state_struct ionized_shard_state;
+
+/**
+ * \brief Representation of the shard.
+ */
+struct ionized_shard_struct
+{
+    ionized_shard_state * state; /** Internal state. */
+    ionized_shard_queue_func queue; /** Finds owned queue. */
+    ionized_shard_loop_func loop; /** Gets event loop. */
+    ionized_shard_reaper_func reaper; /** Gets reaper of clients. */
+    ionized_shard_start_func start; /** Starts pinned worker. */
+    ionized_shard_stop_func stop; /** Stops worker. */
+};
+
+/**
+ * \brief Declaration of type returned by ionized_shard_setup.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    ionized_shard shard; /** Shard object, valid on success. */
+}
+ionized_shard_setup_result;
+
+/**
+ * \brief Creates a shard owning no queues yet.
+ * \param index Position of the shard, lower than shards.
+ * \param shards Number of shards the daemon runs.
+ * \param cpu Core the worker is pinned to, negative leaves it unpinned.
+ * \param sampling Latency sampling of queues, as in ionized_queue_setup.
+ * \param quota Budgets charged for buffers of queues, NULL if unlimited.
+ * \return Structure containing error code and shard object.
+ *
+ * Possible error codes:
+ * 1. EINVAL - index isn't lower than shards;
+ * 2. ENOMEM - couldn't allocate memory for shard state;
+ * 3. codes returned by ionized_loop_setup and ionized_reaper_setup.
+ */
+ionized_shard_setup_result ionized_shard_setup(
+    uint32_t const index,
+    uint32_t const shards,
+    int const cpu,
+    uint32_t const sampling,
+    ionized_quota * const quota
+);
+
+/**
+ * \brief Destroys the shard with all its queues.
+ * \param shard Shard to destroy.
+ * \return Zero on success, else error code.
+ *
+ * A running worker is stopped first.
+ * Possible error codes:
+ * 1. EINVAL - invalid shard given;
+ * 2. codes returned by ionized_reaper_cleanup, ionized_queue_cleanup and
+ *    ionized_loop_cleanup.
+ */
+ionize_status ionized_shard_cleanup( ionized_shard * const shard );
+
+#endif /* IONIZED_SHARD_H__ */
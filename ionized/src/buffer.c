@@ -0,0 +1,241 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of shared memory buffer methods.
+ * \date        10/19/2026 01:31:50 PM
+ * \file        buffer.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#define _GNU_SOURCE /* for memfd_create */
+
+#include <errno.h> /* EINVAL, EIO, ENOMEM, ENOTSUP, EOVERFLOW */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/buffer.h>
+#include <plasma/properties.h> /* plasma_properties */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, uint8_t, uint32_t */
+#include <sys/mman.h> /* madvise, memfd_create, mincore, mlock, mmap */
+#include <unistd.h> /* close, ftruncate, sysconf */
+
+static ionize_status map( ionized_buffer * const buffer, size_t const size )
+{
+    if( 0 != ftruncate( buffer->fd, ( off_t ) size ))
+    {
+        return ENOMEM;
+    }
+    void * const memory = mmap(
+        NULL,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        buffer->fd,
+        0
+    );
+    if( MAP_FAILED == memory )
+    {
+        return ENOMEM;
+    }
+    buffer->memory = memory;
+    buffer->size = size;
+    return 0;
+}
+
+static size_t page_size( void )
+{
+    long const page = sysconf( _SC_PAGESIZE );
+    return ( 0 < page ) ? ( size_t ) page : 4096U;
+}
+
+ionized_buffer_setup_result ionized_buffer_setup(
+    plasma_properties const properties,
+    size_t const reserved,
+    uint32_t const flags
+)
+{
+    ionized_buffer_setup_result result =
+    {
+        .status = plasma_properties_validator( properties ),
+        .buffer = { .fd = -1, .memory = NULL, .size = 0U }
+    };
+    if( 0 != result.status )
+    {
+        return result;
+    }
+    if( 0U != ( flags & ~IONIZED_BUFFER_FLAGS ))
+    {
+        result.status = ENOTSUP;
+        return result;
+    }
+    if( SIZE_MAX - reserved < properties.maximum )
+    {
+        result.status = EOVERFLOW;
+        return result;
+    }
+
+    result.buffer.fd = memfd_create( "ionized", MFD_CLOEXEC );
+    if( -1 == result.buffer.fd )
+    {
+        result.status = errno;
+        return result;
+    }
+
+    size_t size = properties.maximum;
+    size_t step = properties.alignment;
+    for( ;; )
+    {
+        result.status = map( &( result.buffer ), reserved + size );
+        if(( 0 == result.status ) || ( properties.minimum == size ))
+        {
+            break;
+        }
+        size = ( size - properties.minimum > step )
+            ? size - step
+            : properties.minimum;
+        step = ( SIZE_MAX / 2U < step ) ? step : step * 2U;
+    }
+    if(( 0 == result.status ) && ( 0U != ( flags & IONIZED_BUFFER_PREFAULT )))
+    {
+        result.status =
+            ionized_buffer_prefault( &( result.buffer ), 0U, SIZE_MAX );
+    }
+    if(( 0 == result.status ) && ( 0U != ( flags & IONIZED_BUFFER_MLOCK )))
+    {
+        result.status = ionized_buffer_lock( &( result.buffer ));
+    }
+    if(( 0 != result.status ) && ( NULL != result.buffer.memory ))
+    {
+        UNUSED( munmap( result.buffer.memory, result.buffer.size ));
+    }
+    if( 0 != result.status )
+    {
+        UNUSED( close( result.buffer.fd ));
+        result.buffer.fd = -1;
+        result.buffer.memory = NULL;
+        result.buffer.size = 0U;
+    }
+    return result;
+}
+
+ionize_status ionized_buffer_prefault(
+    ionized_buffer const * const buffer,
+    size_t const offset,
+    size_t const length
+)
+{
+    if(
+        ( NULL == buffer )
+        || ( NULL == buffer->memory )
+        || ( 0U != offset % page_size())
+    )
+    {
+        return EINVAL;
+    }
+    if( buffer->size <= offset )
+    {
+        return 0;
+    }
+
+    size_t const size = ( buffer->size - offset < length )
+        ? buffer->size - offset
+        : length;
+    uint8_t * const start = ( uint8_t * ) buffer->memory + offset;
+#ifdef MADV_POPULATE_WRITE
+    if( 0 == madvise( start, size, MADV_POPULATE_WRITE ))
+    {
+        return 0;
+    }
+    /* kernels before 5.14 don't know it, else memory ran out */
+    if( EINVAL != errno )
+    {
+        return ENOMEM;
+    }
+#endif /* MADV_POPULATE_WRITE */
+    /* writing allocates pages of the file, reading would map zero page */
+    size_t const step = page_size();
+    volatile uint8_t * const bytes = start;
+    for( size_t i = 0U; i < size; i += step )
+    {
+        bytes[ i ] = bytes[ i ];
+    }
+    return 0;
+}
+
+ionize_status ionized_buffer_lock( ionized_buffer const * const buffer )
+{
+    if(( NULL == buffer ) || ( NULL == buffer->memory ))
+    {
+        return EINVAL;
+    }
+    return ( 0 == mlock( buffer->memory, buffer->size )) ? 0 : errno;
+}
+
+size_t ionized_buffer_cold( ionized_buffer const * const buffer )
+{
+    if(( NULL == buffer ) || ( NULL == buffer->memory ))
+    {
+        return 0U;
+    }
+
+    size_t const page = page_size();
+    size_t const pages = ( buffer->size + page - 1U ) / page;
+    /* vector is filled in pieces, so huge buffers don't need huge stack */
+    unsigned char vector[ 256 ];
+    size_t result = 0U;
+    for( size_t done = 0U; done < pages; done += sizeof( vector ))
+    {
+        size_t const count = ( pages - done < sizeof( vector ))
+            ? pages - done
+            : sizeof( vector );
+        uint8_t * const start = ( uint8_t * ) buffer->memory + done * page;
+        size_t const length = ( pages - done == count )
+            ? buffer->size - done * page
+            : count * page;
+        if( 0 != mincore( start, length, vector ))
+        {
+            return 0U;
+        }
+        for( size_t i = 0U; i < count; ++i )
+        {
+            result += ( 0U == ( vector[ i ] & 1U )) ? 1U : 0U;
+        }
+    }
+    return result;
+}
+
+ionize_status ionized_buffer_release( ionized_buffer const * const buffer )
+{
+    if(( NULL == buffer ) || ( NULL == buffer->memory ))
+    {
+        return EINVAL;
+    }
+    /* MADV_DONTNEED would only unmap pages, memory file would keep them */
+    return ( 0 == madvise( buffer->memory, buffer->size, MADV_REMOVE ))
+        ? 0
+        : errno;
+}
+
+ionize_status ionized_buffer_cleanup( ionized_buffer * const buffer )
+{
+    if(( NULL == buffer ) || ( -1 == buffer->fd ))
+    {
+        return EINVAL;
+    }
+
+    ionize_status result = 0;
+    if(( NULL != buffer->memory )
+        && ( 0 != munmap( buffer->memory, buffer->size )))
+    {
+        result = EIO;
+    }
+    if( 0 != close( buffer->fd ))
+    {
+        result = EIO;
+    }
+    buffer->fd = -1;
+    buffer->memory = NULL;
+    buffer->size = 0U;
+    return result;
+}
@@ -0,0 +1,186 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of queue scaling methods.
+ * \date        10/20/2026 09:48:05 AM
+ * \file        elastic.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* EINVAL, ENOMEM */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/elastic.h>
+#include <ionized/pressure.h> /* ionized_pressure */
+#include <ionized/queue.h> /* ionized_queue, ionized_queue_stats */
+#include <ionized/quota.h> /* IONIZED_QUOTA_DAEMON */
+#include <plasma/properties.h> /* plasma_properties */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* int64_t, uint64_t */
+#include <stdlib.h> /* free, malloc */
+
+ionize_status ionized_elastic_init(
+    ionized_elastic * const self,
+    ionized_elastic_policy const policy
+)
+{
+    if(( NULL == self ) || ( 0U == policy.budget ))
+    {
+        return EINVAL;
+    }
+
+    self->policy = policy;
+    if( 0U == self->policy.minimum )
+    {
+        self->policy.minimum = 1U;
+    }
+    if( 0U == self->policy.idle )
+    {
+        self->policy.idle = IONIZED_ELASTIC_IDLE;
+    }
+    if( 0U == self->policy.patience )
+    {
+        self->policy.patience = IONIZED_ELASTIC_PATIENCE;
+    }
+    self->starved = 0U;
+    self->streak = 0U;
+    return 0;
+}
+
+/* buffers to add to starved queue, as far as the budget allows */
+static size_t growth( ionized_queue_stats const stats, size_t const budget )
+{
+    /* new buffers are assumed to be as big as existing ones, on average */
+    size_t const each = stats.bytes / stats.buffers;
+    size_t const room = ( stats.bytes < budget )
+        ? ( budget - stats.bytes ) / each
+        : 0U;
+    size_t const length = ( 1U < stats.buffers ) ? stats.buffers / 2U : 1U;
+    return ( room < length ) ? room : length;
+}
+
+static ionized_elastic_step_result
+grow(
+    ionized_queue * const queue,
+    ionized_queue_stats const stats,
+    size_t const length
+)
+{
+    ionized_elastic_step_result result = { .status = 0, .change = 0 };
+    if( 0U == length )
+    {
+        return result;
+    }
+
+    plasma_properties * const properties =
+        malloc( length * sizeof( plasma_properties ));
+    if( NULL == properties )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    for( size_t i = 0U; i < length; ++i )
+    {
+        properties[ i ] = stats.properties;
+    }
+    result.status = queue->allocate(
+        queue,
+        IONIZED_QUOTA_DAEMON,
+        properties,
+        length,
+        0U
+    );
+    result.change = ( 0 == result.status ) ? ( int64_t ) length : 0;
+    free( properties );
+    return result;
+}
+
+ionized_elastic_step_result ionized_elastic_step(
+    ionized_elastic * const self,
+    ionized_queue * const queue
+)
+{
+    ionized_elastic_step_result result = { .status = 0, .change = 0 };
+    if(( NULL == self ) || ( NULL == queue ))
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_queue_stats const stats = queue->stats( queue, true );
+    uint64_t const starved = stats.write_waits + stats.write_eagains;
+    uint64_t const previous = self->starved;
+    self->starved = starved;
+    if( 0U == stats.buffers )
+    {
+        return result;
+    }
+
+    ionized_pressure * const pressure = self->policy.pressure;
+    bool const pressed =
+        ( NULL != pressure ) && pressure->active( pressure );
+    self->streak = ( previous != starved ) ? self->streak + 1U : 0U;
+    if( 0U < self->streak )
+    {
+        /* a burst of writers is left to the buffers there are, or to ones
+         * still being populated */
+        if(
+            ( self->streak < self->policy.patience )
+            || ( 0U < stats.populating )
+        )
+        {
+            return result;
+        }
+        self->streak = 0U;
+        size_t const length = growth( stats, self->policy.budget );
+        if( !pressed )
+        {
+            return grow( queue, stats, length );
+        }
+        /* writers wait rather than the kernel kills somebody */
+        UNUSED( pressure->shed( pressure, IONIZED_PRESSURE_REJECTED, length ));
+        return result;
+    }
+
+    /* free_low buffers weren't needed at any point since previous step,
+     * under pressure all free buffers go, needed or not */
+    size_t const surplus =
+        pressed ? stats.free : ( stats.free_low + 1U ) / 2U;
+    size_t const spare = ( self->policy.minimum < stats.buffers )
+        ? stats.buffers - self->policy.minimum
+        : 0U;
+    size_t const length = ( spare < surplus ) ? spare : surplus;
+    size_t retired = 0U;
+    if( 0U < length )
+    {
+        /* buffers still pinned or in use are kept, they aren't surplus */
+        ionized_queue_prune_result const pruned = queue->prune(
+            queue,
+            length,
+            pressed ? 0U : self->policy.idle
+        );
+        result.status = pruned.status;
+        retired = pruned.count;
+        result.change = -( int64_t ) retired;
+        if( pressed && ( 0U < retired ))
+        {
+            UNUSED( pressure->shed(
+                pressure,
+                IONIZED_PRESSURE_SHRUNK,
+                retired
+            ));
+        }
+    }
+    /* buffers kept for the minimum keep no pages */
+    if(( 0 == result.status ) && pressed && ( retired < stats.free ))
+    {
+        result.status = queue->trim( queue );
+        if( 0 == result.status )
+        {
+            UNUSED( pressure->shed( pressure, IONIZED_PRESSURE_TRIMMED, 1U ));
+        }
+    }
+    return result;
+}
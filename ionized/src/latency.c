@@ -0,0 +1,143 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of latency histogram methods.
+ * \date        10/19/2026 11:30:18 AM
+ * \file        latency.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* EINVAL, ERANGE */
+#include <ionize/error.h> /* ionize_status */
+#include <ionized/latency.h>
+#include <stdatomic.h>
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL */
+#include <stdint.h> /* uint32_t, uint64_t */
+
+#define MAXIMUM_SAMPLING 63U
+
+ionize_status ionized_latency_init(
+    ionized_latency * const self,
+    uint32_t const sampling
+)
+{
+    if( NULL == self )
+    {
+        return EINVAL;
+    }
+    if( MAXIMUM_SAMPLING < sampling )
+    {
+        return ERANGE;
+    }
+
+    self->sampling = sampling;
+    atomic_init( &( self->cycles ), 0U );
+    for( uint32_t kind = 0U; kind < IONIZED_LATENCY_KINDS; ++kind )
+    {
+        for( uint32_t i = 0U; i < IONIZED_LATENCY_BUCKETS; ++i )
+        {
+            atomic_init( &( self->buckets[ kind ][ i ] ), 0U );
+        }
+    }
+    return 0;
+}
+
+bool ionized_latency_sample( ionized_latency * const self )
+{
+    uint64_t const mask = ( UINT64_C( 1 ) << self->sampling ) - 1U;
+    uint64_t const cycle = atomic_fetch_add_explicit(
+        &( self->cycles ),
+        1U,
+        memory_order_relaxed
+    );
+    return 0U == ( cycle & mask );
+}
+
+static uint32_t bucket( uint64_t duration )
+{
+    uint32_t result = 0U;
+    while( 1U < duration )
+    {
+        duration >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+void ionized_latency_record(
+    ionized_latency * const self,
+    ionized_latency_kind const kind,
+    uint64_t const from,
+    uint64_t const to
+)
+{
+    if(( 0U == from ) || ( to < from ) || ( IONIZED_LATENCY_KINDS <= kind ))
+    {
+        return;
+    }
+    atomic_fetch_add_explicit(
+        &( self->buckets[ kind ][ bucket( to - from ) ] ),
+        1U,
+        memory_order_relaxed
+    );
+}
+
+ionized_latency_snapshot_result
+ionized_latency_snapshot( ionized_latency * const self )
+{
+    ionized_latency_snapshot_result result;
+
+    result.cycles =
+        atomic_load_explicit( &( self->cycles ), memory_order_relaxed );
+    for( uint32_t kind = 0U; kind < IONIZED_LATENCY_KINDS; ++kind )
+    {
+        for( uint32_t i = 0U; i < IONIZED_LATENCY_BUCKETS; ++i )
+        {
+            result.buckets[ kind ][ i ] = atomic_load_explicit(
+                &( self->buckets[ kind ][ i ] ),
+                memory_order_relaxed
+            );
+        }
+    }
+    return result;
+}
+
+uint64_t ionized_latency_quantile(
+    ionized_latency_snapshot_result const * const snapshot,
+    ionized_latency_kind const kind,
+    uint32_t const permille
+)
+{
+    if(( NULL == snapshot ) || ( IONIZED_LATENCY_KINDS <= kind ))
+    {
+        return 0U;
+    }
+
+    uint64_t total = 0U;
+    for( uint32_t i = 0U; i < IONIZED_LATENCY_BUCKETS; ++i )
+    {
+        total += snapshot->buckets[ kind ][ i ];
+    }
+    if( 0U == total )
+    {
+        return 0U;
+    }
+
+    /* rank of the requested duration, counted from one */
+    uint64_t const clamped = ( 1000U < permille ) ? 1000U : permille;
+    uint64_t const rank = ( total * clamped + 999U ) / 1000U;
+    uint64_t seen = 0U;
+    for( uint32_t i = 0U; i < IONIZED_LATENCY_BUCKETS; ++i )
+    {
+        seen += snapshot->buckets[ kind ][ i ];
+        if(( 0U < seen ) && ( rank <= seen ))
+        {
+            return ( IONIZED_LATENCY_BUCKETS - 1U == i )
+                ? UINT64_MAX
+                : ( UINT64_C( 2 ) << i ) - 1U;
+        }
+    }
+    return UINT64_MAX;
+}
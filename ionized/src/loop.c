@@ -0,0 +1,362 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of event loop methods.
+ * \date        10/21/2026 10:41:12 AM
+ * \file        loop.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* EAGAIN, EEXIST, EINVAL, ENOENT, ENOMEM, ENOTSUP */
+#include <filament/filament.h> /* filament, filament_rx */
+#include <ionize/error.h> /* ionize_status */
+#include <ionized/loop.h>
+#include <ionized/loop/backend.h> /* ionized_loop_backend */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdlib.h> /* free, malloc, realloc */
+#include <string.h> /* memset */
+
+typedef struct watch_struct watch;
+
+struct watch_struct
+{
+    filament const * client;
+    ionized_loop_handler handler;
+    void * context;
+    bool pending; /* on the ready list */
+    bool closed; /* unwatched, freed once no run can reach it */
+    watch * previous;
+    watch * next;
+};
+
+struct ionized_loop_state_struct
+{
+    ionized_loop_backend * backend;
+    watch * watches;
+    size_t watched;
+    watch ** ready; /* clients not drained by previous run */
+    size_t readied;
+    size_t ready_size;
+    watch * closed; /* linked through next */
+};
+
+static watch * find(
+    ionized_loop_state const * const state,
+    filament const * const client
+)
+{
+    for( watch * w = state->watches; NULL != w; w = w->next )
+    {
+        if( client == w->client )
+        {
+            return w;
+        }
+    }
+    return NULL;
+}
+
+static void forget( ionized_loop_state * const state, watch * const w )
+{
+    if( NULL != w->previous )
+    {
+        w->previous->next = w->next;
+    }
+    else
+    {
+        state->watches = w->next;
+    }
+    if( NULL != w->next )
+    {
+        w->next->previous = w->previous;
+    }
+    --( state->watched );
+    ionized_loop_backend_remove(
+        state->backend,
+        w->client->fd( w->client ),
+        w
+    );
+    /* events of this run or the ready list may still point at it */
+    w->closed = true;
+    w->next = state->closed;
+    state->closed = w;
+}
+
+static ionize_status watch_client(
+    ionized_loop * const self,
+    filament const * const client,
+    ionized_loop_handler const handler,
+    void * const context
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( NULL == client )
+        || ( NULL == handler )
+    )
+    {
+        return EINVAL;
+    }
+    if(
+        ( NULL == client->fd )
+        || ( NULL == client->try_rx )
+        || ( -1 == client->fd( client ))
+    )
+    {
+        return ENOTSUP;
+    }
+
+    ionized_loop_state * const state = self->state;
+    if( NULL != find( state, client ))
+    {
+        return EEXIST;
+    }
+    watch * const w = malloc( sizeof( watch ));
+    if( NULL == w )
+    {
+        return ENOMEM;
+    }
+    *w = ( watch )
+    {
+        .client = client,
+        .handler = handler,
+        .context = context,
+        .pending = false,
+        .closed = false,
+        .previous = NULL,
+        .next = state->watches
+    };
+    ionize_status const result =
+        ionized_loop_backend_add( state->backend, client->fd( client ), w );
+    if( 0 != result )
+    {
+        free( w );
+        return result;
+    }
+    if( NULL != state->watches )
+    {
+        state->watches->previous = w;
+    }
+    state->watches = w;
+    ++( state->watched );
+    return 0;
+}
+
+static ionize_status unwatch(
+    ionized_loop * const self,
+    filament const * const client
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ) || ( NULL == client ))
+    {
+        return EINVAL;
+    }
+
+    watch * const w = find( self->state, client );
+    if( NULL == w )
+    {
+        return ENOENT;
+    }
+    forget( self->state, w );
+    return 0;
+}
+
+/* makes room for clients of a whole wait on top of left over ones */
+static ionize_status fit_ready( ionized_loop_state * const state )
+{
+    size_t const needed = state->readied + IONIZED_LOOP_EVENTS;
+    if( needed <= state->ready_size )
+    {
+        return 0;
+    }
+    watch ** const ready = realloc( state->ready, needed * sizeof( watch * ));
+    if( NULL == ready )
+    {
+        return ENOMEM;
+    }
+    state->ready = ready;
+    state->ready_size = needed;
+    return 0;
+}
+
+/* edge-triggered, so readiness is lost unless drained until EAGAIN */
+static bool drain(
+    ionized_loop_state * const state,
+    watch * const w,
+    size_t * const handled
+)
+{
+    for( size_t i = 0U; i < IONIZED_LOOP_BATCH; ++i )
+    {
+        filament_rx const rx = w->client->try_rx( w->client );
+        if( EAGAIN == rx.status )
+        {
+            return false;
+        }
+        ++( *handled );
+        ionize_status const kept = w->handler( w->context, w->client, rx );
+        if( w->closed )
+        {
+            return false;
+        }
+        if(( 0 != rx.status ) || ( 0 != kept ))
+        {
+            forget( state, w );
+            return false;
+        }
+    }
+    return true;
+}
+
+static ionized_loop_run_result
+run( ionized_loop * const self, int const timeout )
+{
+    ionized_loop_run_result result = { .status = 0, .handled = 0U };
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_loop_state * const state = self->state;
+    result.status = fit_ready( state );
+    if( 0 != result.status )
+    {
+        return result;
+    }
+    void * tags[ IONIZED_LOOP_EVENTS ];
+    ionized_loop_backend_wait_result const ready = ionized_loop_backend_wait(
+        state->backend,
+        tags,
+        IONIZED_LOOP_EVENTS,
+        ( 0U == state->readied ) ? timeout : 0
+    );
+    if( 0 != ready.status )
+    {
+        result.status = ready.status;
+        return result;
+    }
+    for( size_t i = 0U; i < ready.count; ++i )
+    {
+        watch * const w = tags[ i ];
+        if( !w->pending && !w->closed )
+        {
+            w->pending = true;
+            state->ready[ state->readied++ ] = w;
+        }
+    }
+
+    size_t kept = 0U;
+    for( size_t i = 0U; i < state->readied; ++i )
+    {
+        watch * const w = state->ready[ i ];
+        if( !w->closed && drain( state, w, &( result.handled )))
+        {
+            state->ready[ kept++ ] = w;
+        }
+        else
+        {
+            w->pending = false;
+        }
+    }
+    /* handlers may have unwatched clients kept above */
+    state->readied = 0U;
+    for( size_t i = 0U; i < kept; ++i )
+    {
+        if( !state->ready[ i ]->closed )
+        {
+            state->ready[ state->readied++ ] = state->ready[ i ];
+        }
+    }
+    while( NULL != state->closed )
+    {
+        watch * const w = state->closed;
+        state->closed = w->next;
+        free( w );
+    }
+    return result;
+}
+
+static ionize_status wake( ionized_loop * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    return ionized_loop_backend_wake( self->state->backend );
+}
+
+static size_t watched( ionized_loop const * const self )
+{
+    return (( NULL == self ) || ( NULL == self->state ))
+        ? 0U
+        : self->state->watched;
+}
+
+ionized_loop_setup_result ionized_loop_setup( void )
+{
+    ionized_loop_setup_result result =
+    {
+        .status = 0,
+        .loop =
+        {
+            .state = NULL,
+            .watch = watch_client,
+            .unwatch = unwatch,
+            .run = run,
+            .wake = wake,
+            .watched = watched
+        }
+    };
+
+    ionized_loop_state * const state = malloc( sizeof( ionized_loop_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memset( state, 0, sizeof( ionized_loop_state ));
+
+    ionized_loop_backend_setup_result const backend =
+        ionized_loop_backend_setup();
+    if( 0 != backend.status )
+    {
+        free( state );
+        result.status = backend.status;
+        return result;
+    }
+    state->backend = backend.backend;
+
+    result.loop.state = state;
+    return result;
+}
+
+ionize_status ionized_loop_cleanup( ionized_loop * const loop )
+{
+    if(( NULL == loop ) || ( NULL == loop->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_loop_state * const state = loop->state;
+    while( NULL != state->watches )
+    {
+        watch * const w = state->watches;
+        state->watches = w->next;
+        free( w );
+    }
+    while( NULL != state->closed )
+    {
+        watch * const w = state->closed;
+        state->closed = w->next;
+        free( w );
+    }
+    free( state->ready );
+    ionize_status const result = ionized_loop_backend_cleanup( state->backend );
+    free( state );
+    loop->state = NULL;
+    return result;
+}
@@ -0,0 +1,161 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Event loop backend on top of edge-triggered epoll.
+ * \date        10/22/2026 02:36:08 PM
+ * \file        epoll.c
+ * \version     1.0
+ *
+ * Default backend, needs nothing beyond the kernel. Descriptors are added
+ * edge-triggered with their tag as event data, the eventfd waking the loop
+ * is the only one with NULL data, so it's told apart without a lookup.
+ * Every add and remove is an epoll_ctl call of its own.
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for ssize_t */
+
+#include <errno.h> /* EAGAIN, EINTR, EIO, ENOMEM */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/loop.h> /* IONIZED_LOOP_EVENTS */
+#include <ionized/loop/backend.h>
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint64_t */
+#include <stdlib.h> /* free, malloc */
+#include <sys/epoll.h> /* epoll_create1, epoll_ctl, epoll_wait */
+#include <sys/eventfd.h> /* eventfd */
+#include <unistd.h> /* close, read, write */
+
+struct ionized_loop_backend_struct
+{
+    int epoll;
+    int wakeup; /* eventfd registered with NULL tag */
+};
+
+ionized_loop_backend_setup_result ionized_loop_backend_setup( void )
+{
+    ionized_loop_backend_setup_result result = { .status = 0, .backend = NULL };
+    ionized_loop_backend * const backend =
+        malloc( sizeof( ionized_loop_backend ));
+    if( NULL == backend )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+
+    backend->epoll = epoll_create1( EPOLL_CLOEXEC );
+    if( -1 == backend->epoll )
+    {
+        result.status = errno;
+        free( backend );
+        return result;
+    }
+    backend->wakeup = eventfd( 0U, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( -1 == backend->wakeup )
+    {
+        result.status = errno;
+        UNUSED( close( backend->epoll ));
+        free( backend );
+        return result;
+    }
+    struct epoll_event event = { .events = EPOLLIN };
+    event.data.ptr = NULL;
+    int const added =
+        epoll_ctl( backend->epoll, EPOLL_CTL_ADD, backend->wakeup, &event );
+    if( 0 != added )
+    {
+        result.status = errno;
+        UNUSED( close( backend->wakeup ));
+        UNUSED( close( backend->epoll ));
+        free( backend );
+        return result;
+    }
+
+    result.backend = backend;
+    return result;
+}
+
+ionize_status ionized_loop_backend_add(
+    ionized_loop_backend * const self,
+    int const fd,
+    void * const tag
+)
+{
+    /* readiness present already is reported by the next epoll_wait */
+    struct epoll_event event = { .events = EPOLLIN | EPOLLET };
+    event.data.ptr = tag;
+    return ( 0 == epoll_ctl( self->epoll, EPOLL_CTL_ADD, fd, &event ))
+        ? 0
+        : errno;
+}
+
+void ionized_loop_backend_remove(
+    ionized_loop_backend * const self,
+    int const fd,
+    void * const tag
+)
+{
+    UNUSED( tag );
+    UNUSED( epoll_ctl( self->epoll, EPOLL_CTL_DEL, fd, NULL ));
+}
+
+ionized_loop_backend_wait_result ionized_loop_backend_wait(
+    ionized_loop_backend * const self,
+    void * * const tags,
+    size_t const capacity,
+    int const timeout
+)
+{
+    ionized_loop_backend_wait_result result = { .status = 0, .count = 0U };
+    struct epoll_event events[ IONIZED_LOOP_EVENTS ];
+    int const ready = epoll_wait(
+        self->epoll,
+        events,
+        ( int ) (( capacity < IONIZED_LOOP_EVENTS )
+            ? capacity
+            : IONIZED_LOOP_EVENTS ),
+        timeout
+    );
+    if( 0 > ready )
+    {
+        result.status = ( EINTR == errno ) ? 0 : errno;
+        return result;
+    }
+    for( int i = 0; i < ready; ++i )
+    {
+        if( NULL == events[ i ].data.ptr )
+        {
+            uint64_t count;
+            UNUSED( read( self->wakeup, &count, sizeof( count )));
+        }
+        else
+        {
+            tags[ result.count++ ] = events[ i ].data.ptr;
+        }
+    }
+    return result;
+}
+
+ionize_status ionized_loop_backend_wake( ionized_loop_backend * const self )
+{
+    uint64_t const one = 1U;
+    ssize_t const written = write( self->wakeup, &one, sizeof( one ));
+    /* counter saturated means a wakeup is pending anyway */
+    return (( sizeof( one ) == ( size_t ) written ) || ( EAGAIN == errno ))
+        ? 0
+        : EIO;
+}
+
+ionize_status ionized_loop_backend_cleanup( ionized_loop_backend * const self )
+{
+    ionize_status result = 0;
+    if( 0 != close( self->wakeup ))
+    {
+        result = EIO;
+    }
+    if( 0 != close( self->epoll ))
+    {
+        result = EIO;
+    }
+    free( self );
+    return result;
+}
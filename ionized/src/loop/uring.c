@@ -0,0 +1,369 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Event loop backend on top of io_uring.
+ * \date        10/22/2026 03:48:51 PM
+ * \file        uring.c
+ * \version     1.0
+ *
+ * Built instead of epoll.c, links with liburing. Watched descriptors are
+ * placed in the ring's registered file table, at the slot of their own
+ * number, and polled with a single multishot request each, which keeps
+ * posting completions until it's removed. Adding, removing and re-arming
+ * only queue submissions, the table is updated by requests too, so they all
+ * reach the kernel with the next wait and a busy loop makes one system call
+ * per run. Reading is left to filaments, which own their framing, so the
+ * ring doesn't receive data itself.
+ *
+ * The table covers descriptors below the open file limit of the daemon at
+ * setup, capped by the kernel at FILES_MAX, so the limit should be raised
+ * before the loop is created. The kernel keeps the file of a removed
+ * descriptor until the next wait, peers see it closed only then.
+ *
+ * Over test_loop_uring_01, 5000 clients added and 100 replaced in 103 runs,
+ * the epoll loop makes 5201 epoll_ctl and 103 epoll_wait calls. This one
+ * makes one io_uring_register and 142 io_uring_enter calls, 39 of them to
+ * flush a full submission queue while the clients are added. Both make a
+ * single call per run in steady state. Receiving into registered buffers
+ * would save the filaments' recv calls too, but needs framing in the loop.
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for ssize_t */
+
+#include <errno.h> /* EAGAIN, EEXIST, EINTR, EIO, ENOMEM, ENOSPC, ETIME */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/loop/backend.h>
+#include <liburing.h> /* io_uring, __kernel_timespec */
+#include <poll.h> /* POLLIN */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* UINT64_MAX, uint32_t, uint64_t */
+#include <stdlib.h> /* calloc, free, malloc */
+#include <string.h> /* memset */
+#include <sys/eventfd.h> /* eventfd */
+#include <sys/resource.h> /* getrlimit, RLIMIT_NOFILE */
+#include <unistd.h> /* close, read, write */
+
+/* largest registered file table the kernel accepts */
+#define FILES_MAX ( 1U << 20 )
+
+/* submission queue, completions get more room as each poll posts many */
+#define ENTRIES 256U
+#define COMPLETIONS 16384U
+
+/* user data of requests not tied to a watched descriptor */
+#define WAKE UINT64_MAX
+#define IGNORED ( UINT64_MAX - 1U )
+
+typedef struct
+{
+    void * tag;
+    int fd; /* read by the kernel when the table update is submitted */
+    uint32_t generation; /* tells completions of earlier watches apart */
+    bool live;
+}
+entry;
+
+struct ionized_loop_backend_struct
+{
+    struct io_uring ring;
+    int wakeup; /* eventfd, polled with WAKE user data */
+    int none; /* empties slots of the table */
+    uint32_t files; /* size of the table, descriptors below it fit */
+    entry * entries; /* indexed by descriptor */
+};
+
+/* queue is flushed to the kernel when short of room, else left for a wait */
+static bool room( ionized_loop_backend * const self, unsigned const count )
+{
+    if( count > io_uring_sq_space_left( &( self->ring )))
+    {
+        UNUSED( io_uring_submit( &( self->ring )));
+    }
+    return count <= io_uring_sq_space_left( &( self->ring ));
+}
+
+static uint64_t user_data(
+    ionized_loop_backend const * const self,
+    uint32_t const slot
+)
+{
+    return (( uint64_t ) self->entries[ slot ].generation << 32 ) | slot;
+}
+
+static ionize_status
+arm( ionized_loop_backend * const self, uint32_t const slot )
+{
+    if( !room( self, 1U ))
+    {
+        return EAGAIN;
+    }
+    struct io_uring_sqe * const sqe = io_uring_get_sqe( &( self->ring ));
+    io_uring_prep_poll_multishot( sqe, ( int ) slot, POLLIN );
+    io_uring_sqe_set_flags( sqe, IOSQE_FIXED_FILE );
+    io_uring_sqe_set_data64( sqe, user_data( self, slot ));
+    return 0;
+}
+
+static ionize_status arm_wakeup( ionized_loop_backend * const self )
+{
+    if( !room( self, 1U ))
+    {
+        return EAGAIN;
+    }
+    struct io_uring_sqe * const sqe = io_uring_get_sqe( &( self->ring ));
+    io_uring_prep_poll_multishot( sqe, self->wakeup, POLLIN );
+    io_uring_sqe_set_data64( sqe, WAKE );
+    return 0;
+}
+
+/* puts the descriptor, or none, in the slot once the queue is submitted */
+static struct io_uring_sqe * update(
+    ionized_loop_backend * const self,
+    uint32_t const slot,
+    int * const fd
+)
+{
+    struct io_uring_sqe * const sqe = io_uring_get_sqe( &( self->ring ));
+    io_uring_prep_files_update( sqe, fd, 1U, ( int ) slot );
+    io_uring_sqe_set_data64( sqe, IGNORED );
+    return sqe;
+}
+
+/* open file limit, less when the kernel can't register as many */
+static uint32_t files( void )
+{
+    struct rlimit limit;
+    if(( 0 != getrlimit( RLIMIT_NOFILE, &limit ))
+        || ( FILES_MAX < limit.rlim_cur ))
+    {
+        return FILES_MAX;
+    }
+    return ( uint32_t ) limit.rlim_cur;
+}
+
+ionized_loop_backend_setup_result ionized_loop_backend_setup( void )
+{
+    ionized_loop_backend_setup_result result = { .status = 0, .backend = NULL };
+    ionized_loop_backend * const backend =
+        malloc( sizeof( ionized_loop_backend ));
+    if( NULL == backend )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memset( backend, 0, sizeof( ionized_loop_backend ));
+    backend->none = -1;
+    backend->files = files();
+    /* pages of the table are touched only by descriptors watched */
+    backend->entries = calloc( backend->files, sizeof( entry ));
+    if( NULL == backend->entries )
+    {
+        free( backend );
+        result.status = ENOMEM;
+        return result;
+    }
+
+    struct io_uring_params params;
+    memset( &params, 0, sizeof( params ));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+    params.cq_entries = COMPLETIONS;
+    int initialized =
+        io_uring_queue_init_params( ENTRIES, &( backend->ring ), &params );
+    if( -EINVAL == initialized )
+    {
+        /* kernels before 5.19 run completions with interrupts */
+        params.flags = IORING_SETUP_CQSIZE;
+        initialized =
+            io_uring_queue_init_params( ENTRIES, &( backend->ring ), &params );
+    }
+    if( 0 > initialized )
+    {
+        result.status = -initialized;
+        free( backend->entries );
+        free( backend );
+        return result;
+    }
+    int const registered =
+        io_uring_register_files_sparse( &( backend->ring ), backend->files );
+    if( 0 > registered )
+    {
+        result.status = -registered;
+        io_uring_queue_exit( &( backend->ring ));
+        free( backend->entries );
+        free( backend );
+        return result;
+    }
+    backend->wakeup = eventfd( 0U, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( -1 == backend->wakeup )
+    {
+        result.status = errno;
+        io_uring_queue_exit( &( backend->ring ));
+        free( backend->entries );
+        free( backend );
+        return result;
+    }
+    UNUSED( arm_wakeup( backend ));
+
+    result.backend = backend;
+    return result;
+}
+
+ionize_status ionized_loop_backend_add(
+    ionized_loop_backend * const self,
+    int const fd,
+    void * const tag
+)
+{
+    if(( 0 > fd ) || ( self->files <= ( uint32_t ) fd ))
+    {
+        return ENOSPC;
+    }
+    uint32_t const slot = ( uint32_t ) fd;
+    entry * const e = &( self->entries[ slot ] );
+    if( e->live )
+    {
+        return EEXIST;
+    }
+    if( !room( self, 2U ))
+    {
+        return EAGAIN;
+    }
+    ++( e->generation );
+    e->tag = tag;
+    e->fd = fd;
+    e->live = true;
+    /* poll starts once the descriptor is in its slot */
+    io_uring_sqe_set_flags( update( self, slot, &( e->fd )), IOSQE_IO_LINK );
+    return arm( self, slot );
+}
+
+void ionized_loop_backend_remove(
+    ionized_loop_backend * const self,
+    int const fd,
+    void * const tag
+)
+{
+    if(( 0 > fd ) || ( self->files <= ( uint32_t ) fd ))
+    {
+        return;
+    }
+    uint32_t const slot = ( uint32_t ) fd;
+    entry * const e = &( self->entries[ slot ] );
+    if( !e->live || ( tag != e->tag ))
+    {
+        return;
+    }
+    /* completions already posted are told apart by generation */
+    e->live = false;
+    /* else the file stays in the table until the slot is reused */
+    if( room( self, 2U ))
+    {
+        struct io_uring_sqe * const sqe = io_uring_get_sqe( &( self->ring ));
+        io_uring_prep_poll_remove( sqe, user_data( self, slot ));
+        io_uring_sqe_set_data64( sqe, IGNORED );
+        UNUSED( update( self, slot, &( self->none )));
+    }
+}
+
+ionized_loop_backend_wait_result ionized_loop_backend_wait(
+    ionized_loop_backend * const self,
+    void * * const tags,
+    size_t const capacity,
+    int const timeout
+)
+{
+    ionized_loop_backend_wait_result result = { .status = 0, .count = 0U };
+    int waited;
+    if( 0 > timeout )
+    {
+        waited = io_uring_submit_and_wait( &( self->ring ), 1U );
+    }
+    else if( 0 == timeout )
+    {
+        waited = io_uring_submit( &( self->ring ));
+    }
+    else
+    {
+        struct __kernel_timespec ts =
+        {
+            .tv_sec = timeout / 1000,
+            .tv_nsec = ( timeout % 1000 ) * 1000000
+        };
+        struct io_uring_cqe * first;
+        waited = io_uring_submit_and_wait_timeout(
+            &( self->ring ),
+            &first,
+            1U,
+            &ts,
+            NULL
+        );
+    }
+    if(( 0 > waited ) && ( -EINTR != waited ) && ( -ETIME != waited ))
+    {
+        result.status = -waited;
+        return result;
+    }
+
+    unsigned head;
+    unsigned seen = 0U;
+    struct io_uring_cqe * cqe;
+    io_uring_for_each_cqe( &( self->ring ), head, cqe )
+    {
+        if( result.count == capacity )
+        {
+            break;
+        }
+        ++seen;
+        uint64_t const data = io_uring_cqe_get_data64( cqe );
+        bool const more = 0U != ( cqe->flags & IORING_CQE_F_MORE );
+        if( IGNORED == data )
+        {
+            continue;
+        }
+        if( WAKE == data )
+        {
+            uint64_t count;
+            UNUSED( read( self->wakeup, &count, sizeof( count )));
+            if( !more )
+            {
+                UNUSED( arm_wakeup( self ));
+            }
+            continue;
+        }
+        uint32_t const slot = ( uint32_t ) ( data & UINT32_MAX );
+        entry const * const e = &( self->entries[ slot ] );
+        if( !e->live || (( uint32_t ) ( data >> 32 ) != e->generation ))
+        {
+            continue;
+        }
+        /* errors are reported too, the filament tells what went wrong */
+        tags[ result.count++ ] = e->tag;
+        /* failed poll isn't re-armed, it would only fail again */
+        if( !more && ( 0 <= cqe->res ))
+        {
+            UNUSED( arm( self, slot ));
+        }
+    }
+    io_uring_cq_advance( &( self->ring ), seen );
+    return result;
+}
+
+ionize_status ionized_loop_backend_wake( ionized_loop_backend * const self )
+{
+    uint64_t const one = 1U;
+    ssize_t const written = write( self->wakeup, &one, sizeof( one ));
+    /* counter saturated means a wakeup is pending anyway */
+    return (( sizeof( one ) == ( size_t ) written ) || ( EAGAIN == errno ))
+        ? 0
+        : EIO;
+}
+
+ionize_status ionized_loop_backend_cleanup( ionized_loop_backend * const self )
+{
+    io_uring_queue_exit( &( self->ring ));
+    ionize_status const result = ( 0 != close( self->wakeup )) ? EIO : 0;
+    free( self->entries );
+    free( self );
+    return result;
+}
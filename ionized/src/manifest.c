@@ -0,0 +1,513 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of manifest functions.
+ * \date        10/23/2026 03:02:11 PM
+ * \file        manifest.c
+ * \version     1.0
+ *
+ * Parsing works on a copy of the text, split in place one line at a time.
+ * Warming creates the queues first, then submits one task per buffer, so
+ * large queues spread over all workers of the pool. Tasks share a counter
+ * of pending buffers, the caller sleeps until the last one is done.
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for pthread */
+
+#include <ctype.h> /* isdigit, isspace */
+#include <errno.h> /* EEXIST, EINVAL, EIO, ENAMETOOLONG, ENOMEM, ENOTSUP */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/log.h> /* IONIZE_ERROR, IONIZE_INFO */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/buffer.h> /* IONIZED_BUFFER_PREFAULT */
+#include <ionized/manifest.h>
+#include <ionized/pool.h> /* ionized_pool, ionized_task */
+#include <ionized/queue.h> /* ionized_queue */
+#include <ionized/shard.h> /* ionized_shard */
+#include <plasma/config.h> /* PLASMA_CONFIG_HEADER, plasma_config */
+#include <plasma/properties.h> /* plasma_properties */
+#include <plasma/shard.h> /* plasma_shard */
+#include <pthread.h>
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, UINT32_MAX, uint32_t, uint64_t */
+#include <stdio.h> /* FILE, fclose, fopen, fread, ferror */
+#include <stdlib.h> /* free, malloc, realloc, strtoull */
+#include <string.h> /* memcpy, strchr, strcmp, strlen */
+
+/* name, uid, count and the three properties */
+#define FIELDS 6U
+
+/* options after the fields, each flag at most once */
+#define TOKENS ( FIELDS + 8U )
+
+typedef struct
+{
+    char const * name;
+    uint32_t config; /* plasma_config_flag values */
+    uint32_t backing; /* ionized_buffer_flag values */
+}
+option;
+
+static option const options[] =
+{
+    { "header", PLASMA_CONFIG_HEADER, 0U },
+    { "overwrite", PLASMA_CONFIG_OVERWRITE, 0U },
+    { "latest", PLASMA_CONFIG_LATEST, 0U },
+    { "priority", PLASMA_CONFIG_PRIORITY, 0U },
+    { "prefault", 0U, IONIZED_BUFFER_PREFAULT },
+    { "mlock", 0U, IONIZED_BUFFER_MLOCK }
+};
+
+static bool number(
+    char const * const token,
+    uint64_t const limit,
+    uint64_t * const value
+)
+{
+    /* strtoull would take signs and blanks */
+    if( !isdigit(( unsigned char ) token[ 0 ] ))
+    {
+        return false;
+    }
+    char * end = NULL;
+    errno = 0;
+    unsigned long long const parsed = strtoull( token, &end, 0 );
+    if(( 0 != errno ) || ( '\0' != *end ) || ( limit < parsed ))
+    {
+        return false;
+    }
+    *value = ( uint64_t ) parsed;
+    return true;
+}
+
+/* splits line in place, returns number of tokens or SIZE_MAX if too many */
+static size_t split( char * line, char * * const tokens )
+{
+    char * const comment = strchr( line, '#' );
+    if( NULL != comment )
+    {
+        *comment = '\0';
+    }
+    size_t count = 0U;
+    for( ;; )
+    {
+        while( isspace(( unsigned char ) *line ))
+        {
+            ++line;
+        }
+        if( '\0' == *line )
+        {
+            return count;
+        }
+        if( TOKENS == count )
+        {
+            return SIZE_MAX;
+        }
+        tokens[ count++ ] = line;
+        while(( '\0' != *line ) && !isspace(( unsigned char ) *line ))
+        {
+            ++line;
+        }
+        if( '\0' != *line )
+        {
+            *( line++ ) = '\0';
+        }
+    }
+}
+
+static ionize_status entry(
+    char * const * const tokens,
+    size_t const count,
+    ionized_manifest_entry * const result
+)
+{
+    if( count < FIELDS )
+    {
+        return EINVAL;
+    }
+    size_t const length = strlen( tokens[ 0 ] );
+    if( IONIZED_MANIFEST_NAME <= length )
+    {
+        return ENAMETOOLONG;
+    }
+    memcpy( result->name, tokens[ 0 ], length + 1U );
+
+    uint64_t values[ FIELDS - 1U ];
+    for( size_t i = 1U; i < FIELDS; ++i )
+    {
+        uint64_t const limit = ( 1U == i )
+            ? UINT32_MAX
+            : ( 2U == i ) ? IONIZED_MANIFEST_BUFFERS : SIZE_MAX;
+        if( !number( tokens[ i ], limit, &( values[ i - 1U ] )))
+        {
+            return EINVAL;
+        }
+    }
+    result->uid = ( uint32_t ) values[ 0 ];
+    result->count = ( size_t ) values[ 1 ];
+    result->properties = ( plasma_properties )
+    {
+        ( size_t ) values[ 2 ],
+        ( size_t ) values[ 3 ],
+        ( size_t ) values[ 4 ]
+    };
+    if( 0U == result->count )
+    {
+        return EINVAL;
+    }
+    ionize_status const valid =
+        plasma_properties_validator( result->properties );
+    if( 0 != valid )
+    {
+        return valid;
+    }
+
+    result->config = ( plasma_config ) { 0U };
+    result->backing = 0U;
+    for( size_t i = FIELDS; i < count; ++i )
+    {
+        size_t known = 0U;
+        while(
+            ( known < sizeof( options ) / sizeof( options[ 0 ] ))
+            && ( 0 != strcmp( tokens[ i ], options[ known ].name ))
+        )
+        {
+            ++known;
+        }
+        if( sizeof( options ) / sizeof( options[ 0 ] ) == known )
+        {
+            return ENOTSUP;
+        }
+        result->config.flags |= options[ known ].config;
+        result->backing |= options[ known ].backing;
+    }
+    return plasma_config_validator( result->config );
+}
+
+ionized_manifest_parse_result ionized_manifest_parse( char const * const text )
+{
+    ionized_manifest_parse_result result =
+    {
+        .status = 0,
+        .line = 0U,
+        .manifest = { .entries = NULL, .count = 0U }
+    };
+    if( NULL == text )
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    size_t const size = strlen( text ) + 1U;
+    char * const copy = malloc( size );
+    if( NULL == copy )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memcpy( copy, text, size );
+
+    char * line = copy;
+    while(( 0 == result.status ) && ( NULL != line ))
+    {
+        ++( result.line );
+        char * const next = strchr( line, '\n' );
+        if( NULL != next )
+        {
+            *next = '\0';
+        }
+        char * tokens[ TOKENS ];
+        size_t const count = split( line, tokens );
+        line = ( NULL == next ) ? NULL : next + 1U;
+        if( 0U == count )
+        {
+            continue;
+        }
+        if( SIZE_MAX == count )
+        {
+            result.status = EINVAL;
+            break;
+        }
+
+        ionized_manifest * const m = &( result.manifest );
+        ionized_manifest_entry * const entries =
+            realloc( m->entries, ( m->count + 1U ) * sizeof( *entries ));
+        if( NULL == entries )
+        {
+            result.status = ENOMEM;
+            result.line = 0U;
+            break;
+        }
+        m->entries = entries;
+        result.status = entry( tokens, count, &( entries[ m->count ] ));
+        for( size_t i = 0U; ( 0 == result.status ) && ( i < m->count ); ++i )
+        {
+            if( entries[ i ].uid == entries[ m->count ].uid )
+            {
+                result.status = EEXIST;
+            }
+        }
+        if( 0 == result.status )
+        {
+            ++( m->count );
+        }
+    }
+    free( copy );
+
+    if( 0 != result.status )
+    {
+        free( result.manifest.entries );
+        result.manifest = ( ionized_manifest ) { NULL, 0U };
+        return result;
+    }
+    result.line = 0U;
+    return result;
+}
+
+ionized_manifest_parse_result ionized_manifest_load( char const * const path )
+{
+    ionized_manifest_parse_result result =
+    {
+        .status = 0,
+        .line = 0U,
+        .manifest = { .entries = NULL, .count = 0U }
+    };
+    if( NULL == path )
+    {
+        result.status = EINVAL;
+        return result;
+    }
+    FILE * const file = fopen( path, "r" );
+    if( NULL == file )
+    {
+        result.status = errno;
+        return result;
+    }
+
+    char * text = NULL;
+    size_t length = 0U;
+    size_t capacity = 0U;
+    for( ;; )
+    {
+        /* room for another chunk and the terminating null */
+        if( capacity - length < BUFSIZ + 1U )
+        {
+            capacity = 2U * capacity + BUFSIZ + 1U;
+            char * const grown = realloc( text, capacity );
+            if( NULL == grown )
+            {
+                result.status = ENOMEM;
+                break;
+            }
+            text = grown;
+        }
+        size_t const chunk = fread( text + length, 1U, BUFSIZ, file );
+        length += chunk;
+        if( BUFSIZ != chunk )
+        {
+            result.status = ferror( file ) ? EIO : 0;
+            break;
+        }
+    }
+    UNUSED( fclose( file ));
+    if( 0 == result.status )
+    {
+        text[ length ] = '\0';
+        result = ionized_manifest_parse( text );
+    }
+    free( text );
+    return result;
+}
+
+/* shared by all tasks of one warm call */
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t done;
+    size_t pending;
+    ionize_status status; /* first failure */
+}
+warming;
+
+typedef struct
+{
+    ionized_task task;
+    ionized_queue * queue;
+    plasma_properties properties;
+    warming * shared;
+}
+job;
+
+static void allocate( ionized_task * const task )
+{
+    job * const j = task->context;
+    ionize_status const result =
+        j->queue->allocate( j->queue, 0U, &( j->properties ), 1U, 0U );
+    warming * const shared = j->shared;
+    UNUSED( pthread_mutex_lock( &( shared->mutex )));
+    if(( 0 != result ) && ( 0 == shared->status ))
+    {
+        shared->status = result;
+    }
+    if( 0U == --( shared->pending ))
+    {
+        UNUSED( pthread_cond_signal( &( shared->done )));
+    }
+    UNUSED( pthread_mutex_unlock( &( shared->mutex )));
+}
+
+/* queues are created and configured one by one, before any buffer */
+static ionize_status prepare(
+    ionized_manifest const * const manifest,
+    ionized_shard * const * const shards,
+    uint32_t const count,
+    ionized_queue * * const queues
+)
+{
+    for( size_t i = 0U; i < manifest->count; ++i )
+    {
+        ionized_manifest_entry const * const e = &( manifest->entries[ i ] );
+        ionized_shard * const shard = shards[ plasma_shard( e->uid, count )];
+        ionized_shard_queue_result const found = shard->queue( shard, e->uid );
+        ionize_status result = found.status;
+        if( 0 == result )
+        {
+            queues[ i ] = found.queue;
+            result = found.queue->configure( found.queue, e->config );
+        }
+        if( 0 == result )
+        {
+            result = found.queue->backing( found.queue, e->backing );
+        }
+        if( 0 != result )
+        {
+            IONIZE_ERROR( "manifest queue %s failed: %d", e->name, result );
+            return result;
+        }
+    }
+    return 0;
+}
+
+ionize_status ionized_manifest_warm(
+    ionized_manifest const * const manifest,
+    ionized_shard * const * const shards,
+    uint32_t const count,
+    ionized_pool * const pool,
+    size_t const producer
+)
+{
+    if(( NULL == manifest ) || ( NULL == shards ) || ( 0U == count ))
+    {
+        return EINVAL;
+    }
+    for( uint32_t i = 0U; i < count; ++i )
+    {
+        if( NULL == shards[ i ] )
+        {
+            return EINVAL;
+        }
+    }
+
+    /* manifests built by hand skip the limits of the parser */
+    size_t total = 0U;
+    for( size_t i = 0U; i < manifest->count; ++i )
+    {
+        size_t const buffers = manifest->entries[ i ].count;
+        if( SIZE_MAX / sizeof( job ) - 1U - total < buffers )
+        {
+            return EINVAL;
+        }
+        total += buffers;
+    }
+    if( SIZE_MAX / sizeof( ionized_queue * ) - 1U < manifest->count )
+    {
+        return EINVAL;
+    }
+    ionized_queue * * const queues =
+        malloc(( manifest->count + 1U ) * sizeof( ionized_queue * ));
+    job * const jobs = malloc(( total + 1U ) * sizeof( job ));
+    if(( NULL == queues ) || ( NULL == jobs ))
+    {
+        free( queues );
+        free( jobs );
+        return ENOMEM;
+    }
+    ionize_status result = prepare( manifest, shards, count, queues );
+    if( 0 != result )
+    {
+        free( queues );
+        free( jobs );
+        return result;
+    }
+
+    warming shared = { .pending = total, .status = 0 };
+    if( 0 != pthread_mutex_init( &( shared.mutex ), NULL ))
+    {
+        free( queues );
+        free( jobs );
+        return EIO;
+    }
+    if( 0 != pthread_cond_init( &( shared.done ), NULL ))
+    {
+        UNUSED( pthread_mutex_destroy( &( shared.mutex )));
+        free( queues );
+        free( jobs );
+        return EIO;
+    }
+    size_t next = 0U;
+    for( size_t i = 0U; i < manifest->count; ++i )
+    {
+        for( size_t b = 0U; b < manifest->entries[ i ].count; ++b, ++next )
+        {
+            job * const j = &( jobs[ next ] );
+            j->task = ( ionized_task ) { allocate, j };
+            j->queue = queues[ i ];
+            j->properties = manifest->entries[ i ].properties;
+            j->shared = &shared;
+            /* full deque or no pool, the buffer is allocated here */
+            if(
+                ( NULL == pool )
+                || ( 0 != pool->submit( pool, producer, &( j->task )))
+            )
+            {
+                allocate( &( j->task ));
+            }
+        }
+    }
+    UNUSED( pthread_mutex_lock( &( shared.mutex )));
+    while( 0U != shared.pending )
+    {
+        UNUSED( pthread_cond_wait( &( shared.done ), &( shared.mutex )));
+    }
+    result = shared.status;
+    UNUSED( pthread_mutex_unlock( &( shared.mutex )));
+    UNUSED( pthread_cond_destroy( &( shared.done )));
+    UNUSED( pthread_mutex_destroy( &( shared.mutex )));
+    free( queues );
+    free( jobs );
+
+    if( 0 != result )
+    {
+        IONIZE_ERROR( "manifest buffers failed: %d", result );
+        return result;
+    }
+    IONIZE_INFO(
+        "manifest warmed %zu buffers of %zu queues",
+        total,
+        manifest->count
+    );
+    return 0;
+}
+
+ionize_status ionized_manifest_cleanup( ionized_manifest * const manifest )
+{
+    if( NULL == manifest )
+    {
+        return EINVAL;
+    }
+
+    free( manifest->entries );
+    manifest->entries = NULL;
+    manifest->count = 0U;
+    return 0;
+}
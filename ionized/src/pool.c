@@ -0,0 +1,416 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of work-stealing pool methods.
+ * \date        10/22/2026 10:02:45 AM
+ * \file        pool.c
+ * \version     1.0
+ *
+ * Deques follow Chase and Lev, with C11 atomics as given by Le, Pop, Cohen
+ * and Zappa Nardelli in "Correct and Efficient Work-Stealing for Weak Memory
+ * Models". They don't grow, a full deque is reported to the producer.
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for pthread */
+
+#include <errno.h> /* EAGAIN, EINVAL, EIO, ENOMEM, ERANGE */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/pool.h>
+#include <pthread.h>
+#include <stdalign.h> /* alignas */
+#include <stdatomic.h> /* atomic_* */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* int64_t, uint64_t */
+#include <stdlib.h> /* free, malloc */
+#include <string.h> /* memset */
+
+#define MASK (( int64_t ) IONIZED_POOL_DEPTH - 1 )
+
+typedef struct
+{
+    alignas( 64 ) atomic_int_fast64_t top; /* stolen from here */
+    alignas( 64 ) atomic_int_fast64_t bottom; /* owner pushes and takes here */
+    _Atomic( ionized_task * ) slots[ IONIZED_POOL_DEPTH ];
+}
+deque;
+
+typedef struct
+{
+    ionized_pool_state * pool;
+    size_t index; /* of its deque */
+    uint64_t seed; /* for choosing victims */
+    pthread_t thread;
+}
+worker;
+
+struct ionized_pool_state_struct
+{
+    deque * deques; /* producers first, then workers */
+    size_t count;
+    size_t producers;
+    worker * workers;
+    size_t started;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    atomic_size_t sleepers;
+    atomic_bool stopping;
+    atomic_uint_fast64_t executed;
+    atomic_uint_fast64_t stolen;
+};
+
+/* deque of the worker running current thread, if any */
+static _Thread_local worker * local = NULL;
+
+static bool push( deque * const d, ionized_task * const task )
+{
+    int64_t const b =
+        atomic_load_explicit( &( d->bottom ), memory_order_relaxed );
+    int64_t const t =
+        atomic_load_explicit( &( d->top ), memory_order_acquire );
+    if( MASK < b - t )
+    {
+        return false;
+    }
+    atomic_store_explicit(
+        &( d->slots[ b & MASK ] ),
+        task,
+        memory_order_relaxed
+    );
+    atomic_thread_fence( memory_order_release );
+    atomic_store_explicit( &( d->bottom ), b + 1, memory_order_relaxed );
+    return true;
+}
+
+/* owner only, newest task first */
+static ionized_task * take( deque * const d )
+{
+    int64_t const b =
+        atomic_load_explicit( &( d->bottom ), memory_order_relaxed ) - 1;
+    atomic_store_explicit( &( d->bottom ), b, memory_order_relaxed );
+    atomic_thread_fence( memory_order_seq_cst );
+    int64_t t = atomic_load_explicit( &( d->top ), memory_order_relaxed );
+    ionized_task * task = NULL;
+    if( t <= b )
+    {
+        task = atomic_load_explicit(
+            &( d->slots[ b & MASK ] ),
+            memory_order_relaxed
+        );
+        if( t == b )
+        {
+            /* last task, race thieves for it */
+            if( !atomic_compare_exchange_strong_explicit(
+                        &( d->top ),
+                        &t,
+                        t + 1,
+                        memory_order_seq_cst,
+                        memory_order_relaxed
+            ))
+            {
+                task = NULL;
+            }
+            atomic_store_explicit(
+                &( d->bottom ),
+                b + 1,
+                memory_order_relaxed
+            );
+        }
+    }
+    else
+    {
+        atomic_store_explicit( &( d->bottom ), b + 1, memory_order_relaxed );
+    }
+    return task;
+}
+
+/* anyone, oldest task first, NULL only if empty */
+static ionized_task * steal( deque * const d )
+{
+    for( ;; )
+    {
+        int64_t t = atomic_load_explicit( &( d->top ), memory_order_acquire );
+        atomic_thread_fence( memory_order_seq_cst );
+        int64_t const b =
+            atomic_load_explicit( &( d->bottom ), memory_order_acquire );
+        if( b <= t )
+        {
+            return NULL;
+        }
+        ionized_task * const task = atomic_load_explicit(
+            &( d->slots[ t & MASK ] ),
+            memory_order_relaxed
+        );
+        /* losing to another thief or the owner means retrying the next one */
+        if( atomic_compare_exchange_strong_explicit(
+                    &( d->top ),
+                    &t,
+                    t + 1,
+                    memory_order_seq_cst,
+                    memory_order_relaxed
+        ))
+        {
+            return task;
+        }
+    }
+}
+
+static uint64_t next_victim( worker * const w )
+{
+    /* xorshift64, spreading thieves over deques */
+    w->seed ^= w->seed << 13;
+    w->seed ^= w->seed >> 7;
+    w->seed ^= w->seed << 17;
+    return w->seed;
+}
+
+/* one sweep over all other deques, starting at a random one */
+static ionized_task * find( worker * const w )
+{
+    ionized_pool_state * const state = w->pool;
+    size_t const first = ( size_t ) ( next_victim( w ) % state->count );
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        size_t const victim = ( first + i ) % state->count;
+        if( victim == w->index )
+        {
+            continue;
+        }
+        ionized_task * const task = steal( &( state->deques[ victim ] ));
+        if( NULL != task )
+        {
+            UNUSED( atomic_fetch_add( &( state->stolen ), 1U ));
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static void * work( void * const ptr )
+{
+    worker * const w = ptr;
+    ionized_pool_state * const state = w->pool;
+    local = w;
+    for( ;; )
+    {
+        ionized_task * task = take( &( state->deques[ w->index ] ));
+        if( NULL == task )
+        {
+            task = find( w );
+        }
+        if( NULL == task )
+        {
+            UNUSED( pthread_mutex_lock( &( state->mutex )));
+            UNUSED( atomic_fetch_add( &( state->sleepers ), 1U ));
+            /* producers check sleepers after pushing, so look once more */
+            task = find( w );
+            if(( NULL == task ) && atomic_load( &( state->stopping )))
+            {
+                UNUSED( atomic_fetch_sub( &( state->sleepers ), 1U ));
+                UNUSED( pthread_mutex_unlock( &( state->mutex )));
+                break;
+            }
+            if( NULL == task )
+            {
+                UNUSED( pthread_cond_wait(
+                            &( state->wake ),
+                            &( state->mutex )
+                ));
+            }
+            UNUSED( atomic_fetch_sub( &( state->sleepers ), 1U ));
+            UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        }
+        if( NULL != task )
+        {
+            task->run( task );
+            UNUSED( atomic_fetch_add( &( state->executed ), 1U ));
+        }
+    }
+    local = NULL;
+    return NULL;
+}
+
+static ionize_status submit(
+    ionized_pool * const self,
+    size_t const producer,
+    ionized_task * const task
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( NULL == task )
+        || ( NULL == task->run )
+    )
+    {
+        return EINVAL;
+    }
+
+    ionized_pool_state * const state = self->state;
+    deque * d = NULL;
+    if(( NULL != local ) && ( state == local->pool ))
+    {
+        d = &( state->deques[ local->index ] );
+    }
+    else if( producer < state->producers )
+    {
+        d = &( state->deques[ producer ] );
+    }
+    else
+    {
+        return ERANGE;
+    }
+    if( !push( d, task ))
+    {
+        return EAGAIN;
+    }
+    atomic_thread_fence( memory_order_seq_cst );
+    if( 0U != atomic_load( &( state->sleepers )))
+    {
+        UNUSED( pthread_mutex_lock( &( state->mutex )));
+        UNUSED( pthread_cond_signal( &( state->wake )));
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    }
+    return 0;
+}
+
+static ionized_pool_stats stats( ionized_pool const * const self )
+{
+    ionized_pool_stats result = { .executed = 0U, .stolen = 0U };
+    if(( NULL != self ) && ( NULL != self->state ))
+    {
+        result.executed = atomic_load( &( self->state->executed ));
+        result.stolen = atomic_load( &( self->state->stolen ));
+    }
+    return result;
+}
+
+static ionize_status stop( ionized_pool_state * const state )
+{
+    atomic_store( &( state->stopping ), true );
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    UNUSED( pthread_cond_broadcast( &( state->wake )));
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    ionize_status result = 0;
+    for( size_t i = 0U; i < state->started; ++i )
+    {
+        if( 0 != pthread_join( state->workers[ i ].thread, NULL ))
+        {
+            result = EIO;
+        }
+    }
+    state->started = 0U;
+    return result;
+}
+
+static void destroy( ionized_pool_state * const state )
+{
+    UNUSED( pthread_cond_destroy( &( state->wake )));
+    UNUSED( pthread_mutex_destroy( &( state->mutex )));
+    free( state->workers );
+    free( state->deques );
+    free( state );
+}
+
+ionized_pool_setup_result ionized_pool_setup(
+    size_t const workers,
+    size_t const producers
+)
+{
+    ionized_pool_setup_result result =
+    {
+        .status = 0,
+        .pool =
+        {
+            .state = NULL,
+            .submit = submit,
+            .stats = stats
+        }
+    };
+    if( 0U == workers )
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_pool_state * const state = malloc( sizeof( ionized_pool_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memset( state, 0, sizeof( ionized_pool_state ));
+    state->count = producers + workers;
+    state->producers = producers;
+    state->deques = aligned_alloc(
+        alignof( deque ),
+        state->count * sizeof( deque )
+    );
+    state->workers = malloc( workers * sizeof( worker ));
+    if(( NULL == state->deques ) || ( NULL == state->workers ))
+    {
+        free( state->workers );
+        free( state->deques );
+        free( state );
+        result.status = ENOMEM;
+        return result;
+    }
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        atomic_init( &( state->deques[ i ].top ), 0 );
+        atomic_init( &( state->deques[ i ].bottom ), 0 );
+    }
+    atomic_init( &( state->sleepers ), 0U );
+    atomic_init( &( state->stopping ), false );
+    atomic_init( &( state->executed ), 0U );
+    atomic_init( &( state->stolen ), 0U );
+    if( 0 != pthread_mutex_init( &( state->mutex ), NULL ))
+    {
+        free( state->workers );
+        free( state->deques );
+        free( state );
+        result.status = EIO;
+        return result;
+    }
+    if( 0 != pthread_cond_init( &( state->wake ), NULL ))
+    {
+        UNUSED( pthread_mutex_destroy( &( state->mutex )));
+        free( state->workers );
+        free( state->deques );
+        free( state );
+        result.status = EIO;
+        return result;
+    }
+
+    for( size_t i = 0U; i < workers; ++i )
+    {
+        worker * const w = &( state->workers[ i ] );
+        w->pool = state;
+        w->index = producers + i;
+        w->seed = 0x9E3779B97F4A7C15U * ( i + 1U );
+        result.status = pthread_create( &( w->thread ), NULL, work, w );
+        if( 0 != result.status )
+        {
+            UNUSED( stop( state ));
+            destroy( state );
+            return result;
+        }
+        ++( state->started );
+    }
+
+    result.pool.state = state;
+    return result;
+}
+
+ionize_status ionized_pool_cleanup( ionized_pool * const pool )
+{
+    if(( NULL == pool ) || ( NULL == pool->state ))
+    {
+        return EINVAL;
+    }
+
+    ionize_status const result = stop( pool->state );
+    destroy( pool->state );
+    pool->state = NULL;
+    return result;
+}
@@ -0,0 +1,170 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of parallel prefaulting.
+ * \date        10/24/2026 10:04:51 AM
+ * \file        prefault.c
+ * \version     1.0
+ *
+ * Shared state is counted, the last of the caller and the helpers frees it.
+ * Helpers run after the caller returned only touch the chunk counter, as
+ * the buffers may be gone by then.
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for pthread */
+
+#include <errno.h> /* EINVAL, EIO, ENOMEM */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/buffer.h> /* ionized_buffer, ionized_buffer_prefault */
+#include <ionized/pool.h> /* ionized_pool, ionized_task */
+#include <ionized/prefault.h>
+#include <pthread.h>
+#include <stdatomic.h> /* atomic_fetch_add, atomic_fetch_sub, atomic_init */
+#include <stddef.h> /* NULL, size_t */
+#include <stdlib.h> /* free, malloc */
+
+/* more helpers rarely help, memory bandwidth runs out first */
+#define HELPERS 16U
+
+typedef struct
+{
+    atomic_size_t references;
+    atomic_size_t next; /* chunk taken by the next thread */
+    size_t total; /* number of chunks */
+    ionized_buffer const * buffers;
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+    size_t done; /* chunks prefaulted or failed */
+    ionize_status status; /* first failure */
+    ionized_task helpers[ HELPERS ];
+}
+job;
+
+static size_t chunks( ionized_buffer const * const buffer )
+{
+    return
+        ( buffer->size + IONIZED_PREFAULT_CHUNK - 1U ) / IONIZED_PREFAULT_CHUNK;
+}
+
+static void drop( job * const j )
+{
+    if( 1U == atomic_fetch_sub( &( j->references ), 1U ))
+    {
+        UNUSED( pthread_cond_destroy( &( j->finished )));
+        UNUSED( pthread_mutex_destroy( &( j->mutex )));
+        free( j );
+    }
+}
+
+static void work( job * const j )
+{
+    for( ;; )
+    {
+        size_t chunk = atomic_fetch_add( &( j->next ), 1U );
+        if( j->total <= chunk )
+        {
+            return;
+        }
+        size_t i = 0U;
+        while( chunks( &( j->buffers[ i ] )) <= chunk )
+        {
+            chunk -= chunks( &( j->buffers[ i++ ] ));
+        }
+        ionize_status const result = ionized_buffer_prefault(
+            &( j->buffers[ i ] ),
+            chunk * IONIZED_PREFAULT_CHUNK,
+            IONIZED_PREFAULT_CHUNK
+        );
+
+        UNUSED( pthread_mutex_lock( &( j->mutex )));
+        if(( 0 != result ) && ( 0 == j->status ))
+        {
+            j->status = result;
+        }
+        if( j->total == ++( j->done ))
+        {
+            UNUSED( pthread_cond_broadcast( &( j->finished )));
+        }
+        UNUSED( pthread_mutex_unlock( &( j->mutex )));
+    }
+}
+
+static void help( ionized_task * const task )
+{
+    job * const j = task->context;
+    work( j );
+    drop( j );
+}
+
+ionize_status ionized_prefault(
+    ionized_buffer const * const buffers,
+    size_t const count,
+    ionized_pool * const pool,
+    size_t const producer
+)
+{
+    if(( NULL == buffers ) && ( 0U != count ))
+    {
+        return EINVAL;
+    }
+    size_t total = 0U;
+    for( size_t i = 0U; i < count; ++i )
+    {
+        if( NULL == buffers[ i ].memory )
+        {
+            return EINVAL;
+        }
+        total += chunks( &( buffers[ i ] ));
+    }
+    if( 0U == total )
+    {
+        return 0;
+    }
+
+    job * const j = malloc( sizeof( job ));
+    if( NULL == j )
+    {
+        return ENOMEM;
+    }
+    atomic_init( &( j->references ), 1U );
+    atomic_init( &( j->next ), 0U );
+    j->total = total;
+    j->buffers = buffers;
+    j->done = 0U;
+    j->status = 0;
+    if( 0 != pthread_mutex_init( &( j->mutex ), NULL ))
+    {
+        free( j );
+        return EIO;
+    }
+    if( 0 != pthread_cond_init( &( j->finished ), NULL ))
+    {
+        UNUSED( pthread_mutex_destroy( &( j->mutex )));
+        free( j );
+        return EIO;
+    }
+
+    /* this thread takes a chunk too, so one less helper is needed */
+    size_t const wanted = ( HELPERS < total - 1U ) ? HELPERS : total - 1U;
+    for( size_t i = 0U; ( NULL != pool ) && ( i < wanted ); ++i )
+    {
+        j->helpers[ i ] = ( ionized_task ) { help, j };
+        atomic_fetch_add( &( j->references ), 1U );
+        if( 0 != pool->submit( pool, producer, &( j->helpers[ i ] )))
+        {
+            atomic_fetch_sub( &( j->references ), 1U );
+            break;
+        }
+    }
+
+    work( j );
+    UNUSED( pthread_mutex_lock( &( j->mutex )));
+    while( j->done < j->total )
+    {
+        UNUSED( pthread_cond_wait( &( j->finished ), &( j->mutex )));
+    }
+    ionize_status const result = j->status;
+    UNUSED( pthread_mutex_unlock( &( j->mutex )));
+    drop( j );
+    return result;
+}
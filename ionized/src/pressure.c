@@ -0,0 +1,262 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of memory pressure monitor methods.
+ * \date        10/24/2026 04:05:40 PM
+ * \file        pressure.c
+ * \version     1.0
+ *
+ * The trigger descriptor reports POLLPRI, which the event loops don't wait
+ * for, so the monitor has a thread of its own. It sleeps in poll nearly all
+ * the time, waking on triggers and on the stop event.
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for pthread */
+
+#include <errno.h> /* EINTR, EINVAL, EIO, ENOMEM */
+#include <fcntl.h> /* open, O_CLOEXEC, O_NONBLOCK, O_RDWR */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/log.h> /* IONIZE_ERROR, IONIZE_WARNING */
+#include <ionize/time.h> /* ionize_time */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/pressure.h>
+#include <poll.h> /* poll, POLLERR, POLLIN, POLLPRI */
+#include <pthread.h>
+#include <stdatomic.h> /* atomic_* */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint32_t, uint64_t */
+#include <stdio.h> /* snprintf */
+#include <stdlib.h> /* free, malloc */
+#include <sys/eventfd.h> /* eventfd */
+#include <sys/types.h> /* ssize_t */
+#include <unistd.h> /* close, write */
+
+#define WINDOW_MIN 500000U
+#define WINDOW_MAX 10000000U
+
+struct ionized_pressure_state_struct
+{
+    int trigger;
+    int stop; /* eventfd waking the thread to exit */
+    uint64_t window; /* in ns */
+    pthread_t thread;
+    atomic_uint_fast64_t last; /* time of the last trigger, zero if none */
+    atomic_uint_fast64_t events;
+    atomic_uint_fast64_t counts[ IONIZED_PRESSURE_TRIMMED + 1 ];
+};
+
+static void * monitor( void * const ptr )
+{
+    ionized_pressure_state * const state = ptr;
+    struct pollfd fds[ 2 ] =
+    {
+        { .fd = state->trigger, .events = POLLPRI },
+        { .fd = state->stop, .events = POLLIN }
+    };
+    for( ;; )
+    {
+        if( 0 > poll( fds, 2U, -1 ))
+        {
+            if( EINTR == errno )
+            {
+                continue;
+            }
+            IONIZE_ERROR( "pressure monitor failed: %d", errno );
+            return NULL;
+        }
+        if( 0 != ( fds[ 1 ].revents & POLLIN ))
+        {
+            return NULL;
+        }
+        /* cgroup of the trigger was removed */
+        if( 0 != ( fds[ 0 ].revents & POLLERR ))
+        {
+            IONIZE_ERROR( "pressure trigger is gone" );
+            return NULL;
+        }
+        if( 0 != ( fds[ 0 ].revents & POLLPRI ))
+        {
+            /* kernel fires at most once per window, logging is cheap */
+            IONIZE_WARNING( "memory pressure, shedding buffers" );
+            atomic_store( &( state->last ), ionize_time());
+            atomic_fetch_add( &( state->events ), 1U );
+        }
+    }
+}
+
+static bool active( ionized_pressure const * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return false;
+    }
+    uint64_t const last = atomic_load( &( self->state->last ));
+    return ( 0U != last ) && ( ionize_time() - last < self->state->window );
+}
+
+static ionize_status shed(
+    ionized_pressure * const self,
+    ionized_pressure_action const action,
+    uint64_t const count
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( IONIZED_PRESSURE_TRIMMED < action )
+    )
+    {
+        return EINVAL;
+    }
+    atomic_fetch_add( &( self->state->counts[ action ] ), count );
+    return 0;
+}
+
+static ionized_pressure_stats stats( ionized_pressure const * const self )
+{
+    ionized_pressure_stats result = { 0U, 0U, 0U, 0U, false };
+    if(( NULL != self ) && ( NULL != self->state ))
+    {
+        ionized_pressure_state * const state = self->state;
+        result.events = atomic_load( &( state->events ));
+        result.rejected =
+            atomic_load( &( state->counts[ IONIZED_PRESSURE_REJECTED ] ));
+        result.shrunk =
+            atomic_load( &( state->counts[ IONIZED_PRESSURE_SHRUNK ] ));
+        result.trimmed =
+            atomic_load( &( state->counts[ IONIZED_PRESSURE_TRIMMED ] ));
+        result.active = active( self );
+    }
+    return result;
+}
+
+/* registers the trigger, returns the descriptor or -1 with errno set */
+static int arm(
+    char const * const path,
+    uint32_t const stall,
+    uint32_t const window
+)
+{
+    int const fd = open( path, O_RDWR | O_NONBLOCK | O_CLOEXEC );
+    if( -1 == fd )
+    {
+        return -1;
+    }
+    char trigger[ 64 ];
+    int const length = snprintf(
+        trigger,
+        sizeof( trigger ),
+        "some %"PRIu32" %"PRIu32,
+        stall,
+        window
+    );
+    /* kernel takes the terminating null as part of the trigger */
+    if( 0 > write( fd, trigger, ( size_t ) length + 1U ))
+    {
+        int const error = errno;
+        UNUSED( close( fd ));
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+ionized_pressure_setup_result ionized_pressure_setup(
+    ionized_pressure_policy const policy
+)
+{
+    ionized_pressure_setup_result result =
+    {
+        .status = 0,
+        .pressure =
+        {
+            .state = NULL,
+            .active = active,
+            .shed = shed,
+            .stats = stats
+        }
+    };
+    char const * const path =
+        ( NULL == policy.path ) ? IONIZED_PRESSURE_PATH : policy.path;
+    uint32_t const window =
+        ( 0U == policy.window ) ? IONIZED_PRESSURE_WINDOW : policy.window;
+    uint32_t const stall =
+        ( 0U == policy.stall ) ? IONIZED_PRESSURE_STALL : policy.stall;
+    if(( WINDOW_MIN > window ) || ( WINDOW_MAX < window ) || ( window < stall ))
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_pressure_state * const state =
+        malloc( sizeof( ionized_pressure_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    state->window = ( uint64_t ) window * 1000U;
+    atomic_init( &( state->last ), 0U );
+    atomic_init( &( state->events ), 0U );
+    for( size_t i = 0U; i <= IONIZED_PRESSURE_TRIMMED; ++i )
+    {
+        atomic_init( &( state->counts[ i ] ), 0U );
+    }
+
+    state->trigger = arm( path, stall, window );
+    if( -1 == state->trigger )
+    {
+        result.status = errno;
+        free( state );
+        return result;
+    }
+    state->stop = eventfd( 0U, EFD_CLOEXEC );
+    if( -1 == state->stop )
+    {
+        UNUSED( close( state->trigger ));
+        free( state );
+        result.status = EIO;
+        return result;
+    }
+    result.status = pthread_create( &( state->thread ), NULL, monitor, state );
+    if( 0 != result.status )
+    {
+        UNUSED( close( state->stop ));
+        UNUSED( close( state->trigger ));
+        free( state );
+        return result;
+    }
+
+    result.pressure.state = state;
+    return result;
+}
+
+ionize_status ionized_pressure_cleanup( ionized_pressure * const pressure )
+{
+    if(( NULL == pressure ) || ( NULL == pressure->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_pressure_state * const state = pressure->state;
+    ionize_status result = 0;
+    uint64_t const one = 1U;
+    if(
+        (( ssize_t ) sizeof( one ) != write( state->stop, &one, sizeof( one )))
+        || ( 0 != pthread_join( state->thread, NULL ))
+    )
+    {
+        result = EIO;
+    }
+    if( 0 != close( state->stop ))
+    {
+        result = EIO;
+    }
+    if( 0 != close( state->trigger ))
+    {
+        result = EIO;
+    }
+    free( state );
+    pressure->state = NULL;
+    return result;
+}
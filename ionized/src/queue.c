@@ -0,0 +1,2798 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of circular queue methods.
+ * \date        10/19/2026 02:47:36 PM
+ * \file        queue.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#define _POSIX_C_SOURCE 200809L /* for pthread */
+
+#include <errno.h> /* EAGAIN, EBUSY, EINVAL, ENOTSUP, ERANGE, ETIMEDOUT */
+#include <fcntl.h> /* O_CLOEXEC */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/log.h> /* IONIZE_WARNING */
+#include <ionize/time.h> /* ionize_time */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/buffer.h> /* IONIZED_BUFFER_FLAGS, ionized_buffer_lock */
+#include <ionized/latency.h> /* ionized_latency */
+#include <ionized/pool.h> /* ionized_pool */
+#include <ionized/prefault.h> /* ionized_prefault */
+#include <ionized/queue.h>
+#include <ionized/quota.h> /* ionized_quota */
+#include <plasma/config.h> /* plasma_config */
+#include <plasma/header.h> /* plasma_header */
+#include <plasma/properties.h> /* plasma_properties */
+#include <plasma/tag.h> /* plasma_tag */
+#include <plasma/watermark.h> /* plasma_watermark */
+#include <pthread.h>
+#include <stdatomic.h> /* atomic_fetch_add, atomic_init, atomic_size_t */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, UINT64_MAX, uint8_t, uint64_t, uintptr_t */
+#include <stdlib.h> /* free, malloc, realloc */
+#include <string.h> /* memset */
+#include <sys/eventfd.h> /* eventfd */
+#include <unistd.h> /* close, write */
+
+typedef enum
+{
+    RETIRED, /* no buffer, entry can be reused */
+    POPULATING, /* new buffer, its pages are being populated by the pool */
+    FREE,
+    WRITING,
+    READABLE,
+    READING,
+    RETAINED, /* consumed, replayable until a writer reuses it */
+    LENT /* consumed, but still published in other queues */
+}
+slot_state;
+
+/* buffer published in several queues, owned by the origin's slot */
+typedef struct
+{
+    atomic_size_t references;
+    ionized_queue_state * origin;
+    size_t index;
+}
+share;
+
+typedef struct
+{
+    slot_state state;
+    ionized_buffer buffer;
+    uint8_t * data; /* start of data, past the header if there is one */
+    size_t size; /* size of data */
+    size_t committed;
+    uint64_t sequence;
+    uint32_t readers;
+    uint32_t pins; /* snapshots of the buffer, writers can't take it */
+    uint32_t owner; /* client charged for the buffer */
+    uint64_t freed; /* time the buffer became free */
+    uint64_t commit_time;
+    ionized_latency_stamps stamps;
+    share * share; /* NULL unless published in several queues */
+    bool borrowed; /* buffer belongs to another queue's slot */
+    plasma_tag tag;
+    size_t heap; /* position in heap of readable buffers */
+    uint32_t generation; /* changes when a lease is revoked */
+    uint64_t leased; /* time the buffer was locked, zero if not leased */
+    bool dirty; /* holds data of earlier writes */
+    bool released; /* pages were returned, or that failed, since freed */
+    uint32_t backing; /* ionized_buffer_flag values the buffer was made with */
+}
+slot;
+
+/* what's left to dispose of once the mutex is released */
+typedef struct
+{
+    ionized_buffer buffer;
+    share * share; /* last reference of it was dropped */
+}
+leftover;
+
+static leftover const nothing = { { -1, NULL, 0U }, NULL };
+
+/* free buffer pinned by a sweep, handled outside the mutex */
+typedef struct
+{
+    size_t index;
+    ionized_buffer buffer; /* retired one once the sweep is done */
+    size_t header;
+    bool zero; /* policy scrubs and buffer is dirty */
+    bool release; /* buffer is idle, its pages are to be returned */
+}
+swept;
+
+/* task of the pool populating new buffers, publishes them once done */
+typedef struct
+{
+    ionized_task task;
+    ionized_queue_state * state;
+    ionized_pool * pool;
+    size_t producer;
+    bool pinned; /* buffers are locked once populated */
+    ionized_buffer * buffers;
+    size_t count;
+    size_t indices[]; /* slots waiting for the buffers */
+}
+population;
+
+/* buffer pinned by a snapshot, each lock gets its own id */
+typedef struct
+{
+    uint64_t id;
+    size_t index;
+}
+pin;
+
+/* task of the pool sweeping free buffers */
+typedef struct
+{
+    ionized_task task;
+    ionized_queue_state * state;
+    size_t count;
+    swept buffers[];
+}
+sweep;
+
+/* holds of snapshots have this bit set, the rest is id of the pin */
+#define SNAPSHOT (( uint64_t ) 1U << 63 )
+
+/* holds of append reservations have this bit set, the rest is aggregate id */
+#define APPEND (( uint64_t ) 1U << 62 )
+
+#define UNSEALED SIZE_MAX
+
+/* holds of locks carry generation of the slot above its index; revoking
+ * a lease changes the generation, so the late holder is told it's gone */
+#define INDEX (( uint64_t ) UINT32_MAX )
+#define GENERATIONS (( uint32_t ) 1U << 30 )
+
+/* buffer locked for writing, shared by producers appending to it */
+typedef struct
+{
+    atomic_uint_fast64_t id; /* zero when entry is unused */
+    size_t index; /* slot of the buffer */
+    uint8_t * data;
+    int fd;
+    size_t capacity;
+    uint64_t opened;
+    atomic_size_t reserved; /* grows past capacity once buffer is sealed */
+    atomic_size_t committed;
+    atomic_size_t length; /* readable length once sealed */
+    atomic_bool finished;
+}
+aggregate;
+
+typedef struct
+{
+    plasma_watermark watermark;
+    int fd;
+    bool holds; /* whether condition held at last check */
+}
+subscription;
+
+struct ionized_queue_state_struct
+{
+    uint32_t uid;
+    ionized_quota * quota; /* may be NULL */
+    plasma_config config;
+    uint32_t backing; /* ionized_buffer_flag values for new buffers */
+    ionized_pool * pool; /* prefaults new buffers, may be NULL */
+    size_t producer; /* deque of the pool used by allocating thread */
+    pthread_mutex_t mutex;
+    pthread_cond_t changed; /* broadcast whenever a slot changes state */
+    slot * slots;
+    size_t length; /* number of entries in slots, including retired */
+    size_t active; /* number of entries holding a buffer */
+    size_t borrowed; /* number of entries holding another queue's buffer */
+    size_t retiring; /* buffers to retire as soon as they become free */
+    size_t cursor; /* where the search for writable buffer starts */
+    uint64_t sequence; /* sequence number of last commit */
+    size_t free; /* number of free buffers */
+    size_t free_low; /* lowest number of free buffers since stats reset */
+    size_t readable; /* number of committed buffers not locked by readers */
+    size_t bytes; /* memory held by buffers */
+    size_t pending; /* memory held by committed buffers not yet consumed */
+    size_t watermark; /* writers are held back above it, zero disables */
+    ionized_queue_retention retention;
+    ionized_queue_reclamation reclamation;
+    size_t sweeping; /* sweeps which haven't finished yet */
+    size_t populating; /* new buffers the pool hasn't populated yet */
+    uint64_t scrubbed;
+    uint64_t scrubbed_inline;
+    uint64_t reclaimed;
+    uint64_t write_waits;
+    uint64_t write_eagains;
+    uint64_t write_backpressured;
+    uint64_t drops; /* unread buffers taken over by writers */
+    plasma_properties properties; /* properties of last allocation */
+    ionized_latency latency;
+    subscription * subscriptions;
+    size_t subscribed;
+    pthread_rwlock_t appending; /* shared by producers, exclusive to open */
+    aggregate * aggregates;
+    size_t aggregated; /* number of entries in aggregates */
+    aggregate * open; /* buffer taking reservations, may be NULL */
+    uint64_t appends; /* id of the last aggregate opened */
+    uint64_t flush_timeout; /* age at which open buffer is sealed, ns */
+    uint64_t lease; /* age at which locks are revoked, ns, zero disables */
+    uint64_t revoked; /* locks revoked after their lease expired */
+    size_t * heap; /* readable slots, most urgent first, for priority mode */
+    size_t heaped; /* number of entries in heap */
+    size_t heap_size; /* capacity of heap, kept at length of slots */
+    pin * snapshots; /* pins of locked snapshots */
+    size_t snapshotted; /* number of entries in snapshots */
+    uint64_t pinned; /* id of the last snapshot pin */
+};
+
+static size_t reserved( plasma_config const config )
+{
+    return ( 0U != ( config.flags & PLASMA_CONFIG_HEADER ))
+        ? sizeof( plasma_header )
+        : 0U;
+}
+
+static bool matches( slot const * const s, plasma_properties const requested )
+{
+    return ( RETIRED != s->state )
+        && ( requested.minimum <= s->size )
+        && ( s->size <= requested.maximum )
+        && ( 0U == (( uintptr_t ) s->data % requested.alignment ));
+}
+
+static ionized_queue_lock failed( ionize_status const status )
+{
+    return ( ionized_queue_lock )
+    {
+        .status = status,
+        .hold = 0U,
+        .data = NULL,
+        .size = 0U,
+        .fd = -1,
+        .offset = 0U,
+        .sequence = 0U
+    };
+}
+
+static ionized_queue_lock locked(
+    ionized_queue_state const * const state,
+    size_t const index,
+    size_t const size
+)
+{
+    slot const * const s = &( state->slots[ index ] );
+    return ( ionized_queue_lock )
+    {
+        .status = 0,
+        .hold = index | (( uint64_t ) s->generation << 32 ),
+        .data = s->data,
+        .size = size,
+        .fd = s->buffer.fd,
+        .offset = reserved( state->config ),
+        .sequence = ( WRITING == s->state ) ? 0U : s->sequence
+    };
+}
+
+/* slot locked through hold, NULL if there's none or it was revoked */
+static slot * held( ionized_queue_state * const state, uint64_t const hold )
+{
+    uint64_t const index = hold & INDEX;
+    if( state->length <= index )
+    {
+        return NULL;
+    }
+    slot * const s = &( state->slots[ index ] );
+    return (( hold >> 32 ) == s->generation ) ? s : NULL;
+}
+
+/* tells why held found no slot, revoked holds differ from invalid ones */
+static ionize_status rejected(
+    ionized_queue_state const * const state,
+    uint64_t const hold
+)
+{
+    uint64_t const index = hold & INDEX;
+    return (( 0U == ( hold & ( SNAPSHOT | APPEND )))
+            && ( index < state->length )
+            && (( hold >> 32 ) != state->slots[ index ].generation ))
+        ? ETIMEDOUT
+        : EPERM;
+}
+
+static bool prioritized( ionized_queue_state const * const state )
+{
+    return 0U != ( state->config.flags & PLASMA_CONFIG_PRIORITY );
+}
+
+/* whether a should be read before b */
+static bool before(
+    ionized_queue_state const * const state,
+    slot const * const a,
+    slot const * const b
+)
+{
+    if( prioritized( state ))
+    {
+        if( a->tag.priority != b->tag.priority )
+        {
+            return a->tag.priority > b->tag.priority;
+        }
+        uint64_t const da =
+            ( 0U == a->tag.deadline ) ? UINT64_MAX : a->tag.deadline;
+        uint64_t const db =
+            ( 0U == b->tag.deadline ) ? UINT64_MAX : b->tag.deadline;
+        if( da != db )
+        {
+            return da < db;
+        }
+    }
+    return a->sequence < b->sequence;
+}
+
+static void heap_swap(
+    ionized_queue_state * const state,
+    size_t const i,
+    size_t const j
+)
+{
+    size_t const moved = state->heap[ i ];
+    state->heap[ i ] = state->heap[ j ];
+    state->heap[ j ] = moved;
+    state->slots[ state->heap[ i ]].heap = i;
+    state->slots[ state->heap[ j ]].heap = j;
+}
+
+static bool heap_before(
+    ionized_queue_state const * const state,
+    size_t const i,
+    size_t const j
+)
+{
+    return before(
+        state,
+        &( state->slots[ state->heap[ i ]] ),
+        &( state->slots[ state->heap[ j ]] )
+    );
+}
+
+static void heap_sift( ionized_queue_state * const state, size_t i )
+{
+    while(( 0U < i ) && heap_before( state, i, ( i - 1U ) / 2U ))
+    {
+        heap_swap( state, i, ( i - 1U ) / 2U );
+        i = ( i - 1U ) / 2U;
+    }
+    for( ;; )
+    {
+        size_t top = i;
+        size_t const left = 2U * i + 1U;
+        size_t const right = left + 1U;
+        if(( left < state->heaped ) && heap_before( state, left, top ))
+        {
+            top = left;
+        }
+        if(( right < state->heaped ) && heap_before( state, right, top ))
+        {
+            top = right;
+        }
+        if( top == i )
+        {
+            return;
+        }
+        heap_swap( state, i, top );
+        i = top;
+    }
+}
+
+/* capacity is reserved whenever slots grow, so pushing can't fail */
+static void heap_push( ionized_queue_state * const state, slot * const s )
+{
+    s->heap = state->heaped;
+    state->heap[ state->heaped++ ] = ( size_t ) ( s - state->slots );
+    heap_sift( state, s->heap );
+}
+
+static void heap_remove( ionized_queue_state * const state, slot * const s )
+{
+    size_t const position = s->heap;
+    if( position != --( state->heaped ))
+    {
+        heap_swap( state, position, state->heaped );
+        heap_sift( state, position );
+    }
+}
+
+static bool fit_heap( ionized_queue_state * const state )
+{
+    if( state->length <= state->heap_size )
+    {
+        return true;
+    }
+    size_t * const heap =
+        realloc( state->heap, state->length * sizeof( size_t ));
+    if( NULL == heap )
+    {
+        return false;
+    }
+    state->heap = heap;
+    state->heap_size = state->length;
+    return true;
+}
+
+/* whether writer may take the buffer, it's free or retained */
+static bool reusable( slot const * const s )
+{
+    return ( 0U == s->pins )
+        && (( FREE == s->state )
+            || (( RETAINED == s->state ) && ( 0U == s->readers )));
+}
+
+static void take_free( ionized_queue_state * const state )
+{
+    --( state->free );
+    if( state->free < state->free_low )
+    {
+        state->free_low = state->free;
+    }
+}
+
+static void make_free( ionized_queue_state * const state, slot * const s )
+{
+    s->state = FREE;
+    s->freed = ionize_time();
+    s->dirty = true;
+    s->released = false;
+    ++( state->free );
+}
+
+/* caller must cleanup returned buffer, preferably without holding mutex */
+static ionized_buffer retire( ionized_queue_state * const state, slot * s )
+{
+    ionized_buffer const result = s->buffer;
+    if(( FREE == s->state ) || ( RETAINED == s->state ))
+    {
+        take_free( state );
+    }
+    state->bytes -= s->buffer.size;
+    if( NULL != state->quota )
+    {
+        UNUSED( state->quota->refund(
+            state->quota,
+            state->uid,
+            s->owner,
+            s->buffer.size
+        ));
+    }
+    uint32_t const generation = s->generation;
+    memset( s, 0, sizeof( slot ));
+    s->state = RETIRED;
+    s->buffer.fd = -1;
+    s->generation = generation;
+    --( state->active );
+    return result;
+}
+
+static void cleanup_buffer( ionized_buffer buffer )
+{
+    if( -1 != buffer.fd )
+    {
+        UNUSED( ionized_buffer_cleanup( &buffer ));
+    }
+}
+
+static bool holds(
+    ionized_queue_state const * const state,
+    plasma_watermark const watermark
+)
+{
+    size_t const count = ( PLASMA_WATERMARK_WRITABLE_BELOW == watermark.kind )
+        ? state->free
+        : state->readable;
+    /* percentages compared in integers: count / total vs threshold / 100 */
+    uint64_t const scaled = ( PLASMA_WATERMARK_PERCENT == watermark.unit )
+        ? ( uint64_t ) count * 100U
+        : ( uint64_t ) count;
+    uint64_t const limit = ( PLASMA_WATERMARK_PERCENT == watermark.unit )
+        ? ( uint64_t ) watermark.threshold
+            * ( state->active - state->retiring )
+        : ( uint64_t ) watermark.threshold;
+    return ( PLASMA_WATERMARK_WRITABLE_BELOW == watermark.kind )
+        ? ( scaled < limit )
+        : ( limit < scaled );
+}
+
+/* signals subscribers whose condition started to hold, mutex must be held */
+static void notify( ionized_queue_state * const state )
+{
+    for( size_t i = 0U; i < state->subscribed; ++i )
+    {
+        subscription * const sub = &( state->subscriptions[ i ] );
+        bool const now = holds( state, sub->watermark );
+        if( now && !sub->holds )
+        {
+            uint64_t const one = 1U;
+            /* counter overflow only loses edges nobody read anyway */
+            UNUSED( write( sub->fd, &one, sizeof( one )));
+        }
+        sub->holds = now;
+    }
+}
+
+static bool retains( ionized_queue_state const * const state, slot const * s )
+{
+    ionized_queue_retention const policy = state->retention;
+    return (( 0U != policy.count )
+            && ( state->sequence - s->sequence < policy.count ))
+        || (( 0U != policy.age )
+            && ( ionize_time() - s->commit_time < policy.age ));
+}
+
+/* consumed buffer, no longer shared, is either reused, retained or retired */
+static ionized_buffer recycle( ionized_queue_state * const state, slot * s )
+{
+    /* snapshots keep the memory, it's retired once they're gone */
+    if(( 0U < state->retiring ) && ( 0U == s->pins ))
+    {
+        --( state->retiring );
+        return retire( state, s );
+    }
+    make_free( state, s );
+    /* retained buffers count as free, writers may take them any time */
+    if( retains( state, s ))
+    {
+        s->state = RETAINED;
+    }
+    return nothing.buffer;
+}
+
+/* buffer was consumed, shared buffers wait for all queues to consume them */
+static leftover release( ionized_queue_state * const state, slot * s )
+{
+    leftover result = nothing;
+    s->readers = 0U;
+    state->pending -= s->buffer.size;
+    if( NULL != s->share )
+    {
+        share * const shared = s->share;
+        bool const last =
+            ( 1U == atomic_fetch_sub( &( shared->references ), 1U ));
+        if( s->borrowed )
+        {
+            uint32_t const generation = s->generation;
+            memset( s, 0, sizeof( slot ));
+            s->state = RETIRED;
+            s->buffer.fd = -1;
+            s->generation = generation;
+            --( state->borrowed );
+            result.share = last ? shared : NULL;
+            return result;
+        }
+        if( !last )
+        {
+            s->state = LENT;
+            return result;
+        }
+        free( shared );
+        s->share = NULL;
+    }
+    result.buffer = recycle( state, s );
+    return result;
+}
+
+/* origin's slot is recycled once every queue consumed the shared buffer */
+static void finish( share * const shared )
+{
+    ionized_queue_state * const origin = shared->origin;
+    UNUSED( pthread_mutex_lock( &( origin->mutex )));
+    slot * const s = &( origin->slots[ shared->index ] );
+    s->share = NULL;
+    ionized_buffer const retired = recycle( origin, s );
+    notify( origin );
+    UNUSED( pthread_cond_broadcast( &( origin->changed )));
+    UNUSED( pthread_mutex_unlock( &( origin->mutex )));
+    free( shared );
+    cleanup_buffer( retired );
+}
+
+static void dispose( leftover const rest )
+{
+    cleanup_buffer( rest.buffer );
+    if( NULL != rest.share )
+    {
+        finish( rest.share );
+    }
+}
+
+/* write is dropped unread, mutex must be held */
+static ionized_buffer discard( ionized_queue_state * const state, slot * s )
+{
+    ionized_buffer retired = nothing.buffer;
+    if(( 0U < state->retiring ) && ( 0U == s->pins ))
+    {
+        --( state->retiring );
+        retired = retire( state, s );
+    }
+    else
+    {
+        make_free( state, s );
+    }
+    notify( state );
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    return retired;
+}
+
+/* last reader of the buffer is gone, mutex must be held */
+static leftover consumed( ionized_queue_state * const state, slot * s )
+{
+    leftover retired = nothing;
+    /* latest buffer stays readable until superseded */
+    if(( 0U != ( state->config.flags & PLASMA_CONFIG_LATEST ))
+        && ( s->sequence == state->sequence ))
+    {
+        s->state = READABLE;
+        ++( state->readable );
+    }
+    else
+    {
+        retired = release( state, s );
+    }
+    notify( state );
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    return retired;
+}
+
+static ionize_status
+configure( ionized_queue * const self, plasma_config const config )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+    ionize_status result = plasma_config_validator( config );
+    if( 0 != result )
+    {
+        return result;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    if( 0U == state->active )
+    {
+        state->config = config;
+    }
+    else
+    {
+        result = EBUSY;
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return result;
+}
+
+/* runs on the pool, buffers which can't be populated are retired */
+static void populate( ionized_task * const task )
+{
+    population * const job = task->context;
+    ionized_queue_state * const state = job->state;
+    size_t const count = job->count;
+    ionize_status result =
+        ionized_prefault( job->buffers, count, job->pool, job->producer );
+    for( size_t i = 0U; job->pinned && ( 0 == result ) && ( i < count ); ++i )
+    {
+        result = ionized_buffer_lock( &( job->buffers[ i ] ));
+    }
+
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    for( size_t i = 0U; i < count; ++i )
+    {
+        slot * const s = &( state->slots[ job->indices[ i ] ] );
+        job->buffers[ i ] = nothing.buffer;
+        if( 0 != result )
+        {
+            job->buffers[ i ] = retire( state, s );
+            continue;
+        }
+        make_free( state, s );
+        /* memory files start zeroed */
+        s->dirty = false;
+        if( 0U < state->retiring )
+        {
+            --( state->retiring );
+            job->buffers[ i ] = retire( state, s );
+        }
+    }
+    state->populating -= count;
+    notify( state );
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    if( 0 != result )
+    {
+        IONIZE_WARNING(
+            "queue %"PRIu32" retired %zu buffers it couldn't populate: %d",
+            state->uid,
+            count,
+            result
+        );
+    }
+    for( size_t i = 0U; i < count; ++i )
+    {
+        cleanup_buffer( job->buffers[ i ] );
+    }
+    free( job->buffers );
+    free( job );
+}
+
+static ionize_status allocate(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const * const properties,
+    size_t const length,
+    uint32_t const flags
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ) || ( NULL == properties ))
+    {
+        return EINVAL;
+    }
+    if( 0U != ( flags & ~IONIZED_BUFFER_FLAGS ))
+    {
+        return ENOTSUP;
+    }
+    if( 0U == length )
+    {
+        return 0;
+    }
+
+    ionized_queue_state * const state = self->state;
+    ionized_buffer * const buffers = malloc( length * sizeof( ionized_buffer ));
+    if( NULL == buffers )
+    {
+        return ENOMEM;
+    }
+
+    /* configuration can't change once there are buffers, but may until */
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    size_t const header = reserved( state->config );
+    uint32_t const backing = state->backing | flags;
+    ionized_pool * const pool = state->pool;
+    size_t const producer = state->producer;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    /* pages of all buffers are populated by the pool before locking them,
+     * the buffers become free once that's done, without this thread */
+    uint32_t const populated = IONIZED_BUFFER_PREFAULT | IONIZED_BUFFER_MLOCK;
+    bool const offloaded = ( NULL != pool ) && ( 0U != ( backing & populated ));
+    population * const job = offloaded
+        ? malloc( sizeof( population ) + length * sizeof( size_t ))
+        : NULL;
+    if( offloaded && ( NULL == job ))
+    {
+        free( buffers );
+        return ENOMEM;
+    }
+
+    /* mapping memory may take a while, don't block traffic meanwhile */
+    ionize_status result = 0;
+    size_t created = 0U;
+    for( ; created < length; ++created )
+    {
+        ionized_buffer_setup_result const buffer = ionized_buffer_setup(
+            properties[ created ],
+            header,
+            offloaded ? ( backing & ~populated ) : backing
+        );
+        if( 0 != buffer.status )
+        {
+            result = buffer.status;
+            break;
+        }
+        buffers[ created ] = buffer.buffer;
+    }
+
+    /* budgets are charged with what was really allocated */
+    size_t total = 0U;
+    for( size_t i = 0U; i < created; ++i )
+    {
+        total += buffers[ i ].size;
+    }
+    if(( 0 == result ) && ( NULL != state->quota ))
+    {
+        result =
+            state->quota->charge( state->quota, state->uid, client, total );
+    }
+    bool const charged = ( 0 == result ) && ( NULL != state->quota );
+
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    /* buffers were laid out for the header of the old configuration */
+    if(( 0 == result ) && ( header != reserved( state->config )))
+    {
+        result = EAGAIN;
+    }
+    size_t const retired = state->length - state->active - state->borrowed;
+    if(( 0 == result ) && ( retired < length ))
+    {
+        size_t const needed = state->length + length - retired;
+        slot * const slots = realloc( state->slots, needed * sizeof( slot ));
+        if( NULL == slots )
+        {
+            result = ENOMEM;
+        }
+        else
+        {
+            for( size_t i = state->length; i < needed; ++i )
+            {
+                memset( &( slots[ i ] ), 0, sizeof( slot ));
+                slots[ i ].state = RETIRED;
+                slots[ i ].buffer.fd = -1;
+            }
+            state->slots = slots;
+            state->length = needed;
+        }
+    }
+    if(( 0 == result ) && !fit_heap( state ))
+    {
+        result = ENOMEM;
+    }
+    if( 0 == result )
+    {
+        size_t next = 0U;
+        for( size_t i = 0U; ( i < state->length ) && ( next < length ); ++i )
+        {
+            slot * const s = &( state->slots[ i ] );
+            if( RETIRED != s->state )
+            {
+                continue;
+            }
+            s->buffer = buffers[ next ];
+            s->data = ( uint8_t * ) s->buffer.memory + header;
+            s->size = s->buffer.size - header;
+            s->owner = client;
+            s->backing = backing;
+            state->bytes += s->buffer.size;
+            if( offloaded )
+            {
+                s->state = POPULATING;
+                job->indices[ next++ ] = i;
+                continue;
+            }
+            make_free( state, s );
+            /* memory files start zeroed */
+            s->dirty = false;
+            ++next;
+        }
+        state->active += length;
+        state->populating += offloaded ? length : 0U;
+        state->properties = properties[ length - 1U ];
+        notify( state );
+        UNUSED( pthread_cond_broadcast( &( state->changed )));
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    if( 0 != result )
+    {
+        if( charged )
+        {
+            UNUSED( state->quota->refund(
+                state->quota,
+                state->uid,
+                client,
+                total
+            ));
+        }
+        for( size_t i = 0U; i < created; ++i )
+        {
+            cleanup_buffer( buffers[ i ] );
+        }
+    }
+    if(( 0 == result ) && offloaded )
+    {
+        job->task = ( ionized_task ) { populate, job };
+        job->state = state;
+        job->pool = pool;
+        job->producer = producer;
+        job->pinned = 0U != ( backing & IONIZED_BUFFER_MLOCK );
+        job->buffers = buffers;
+        job->count = length;
+        if( 0 != pool->submit( pool, producer, &( job->task )))
+        {
+            populate( &( job->task ));
+        }
+        return 0;
+    }
+    free( job );
+    free( buffers );
+    return result;
+}
+
+static ionize_status backing( ionized_queue * const self, uint32_t const flags )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+    if( 0U != ( flags & ~IONIZED_BUFFER_FLAGS ))
+    {
+        return ENOTSUP;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    state->backing = flags;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+static ionize_status offload(
+    ionized_queue * const self,
+    ionized_pool * const pool,
+    size_t const producer
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    state->pool = pool;
+    state->producer = producer;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+static ionize_status shrink( ionized_queue * const self, size_t const length )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    if( state->active - state->retiring < length )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return ERANGE;
+    }
+    /* buffers are destroyed after the mutex is released */
+    ionized_buffer * const buffers =
+        malloc(( length + 1U ) * sizeof( ionized_buffer ));
+    if( NULL == buffers )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return ENOMEM;
+    }
+    /* free buffers go first, from the back of the queue */
+    size_t retired = 0U;
+    for( size_t i = state->length; ( 0U < i ) && ( retired < length ); --i )
+    {
+        slot * const s = &( state->slots[ i - 1U ] );
+        if( reusable( s ))
+        {
+            buffers[ retired++ ] = retire( state, s );
+        }
+    }
+    state->retiring += length - retired;
+    notify( state );
+    /* waiters may have lost the last matching buffer */
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    for( size_t i = 0U; i < retired; ++i )
+    {
+        cleanup_buffer( buffers[ i ] );
+    }
+    free( buffers );
+    return 0;
+}
+
+static ionized_queue_prune_result prune(
+    ionized_queue * const self,
+    size_t const length,
+    uint64_t const idle
+)
+{
+    ionized_queue_prune_result result = { .status = 0, .count = 0U };
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        result.status = EINVAL;
+        return result;
+    }
+    if( 0U == length )
+    {
+        return result;
+    }
+
+    ionized_queue_state * const state = self->state;
+    ionized_buffer * const buffers = malloc( length * sizeof( ionized_buffer ));
+    if( NULL == buffers )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    uint64_t const now = ionize_time();
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    for(
+        size_t i = state->length;
+        ( 0U < i ) && ( result.count < length );
+        --i
+    )
+    {
+        slot * const s = &( state->slots[ i - 1U ] );
+        if(
+            ( FREE == s->state )
+            && reusable( s )
+            && ( idle <= now - s->freed )
+        )
+        {
+            buffers[ result.count++ ] = retire( state, s );
+        }
+    }
+    if( 0U < result.count )
+    {
+        notify( state );
+        UNUSED( pthread_cond_broadcast( &( state->changed )));
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    for( size_t i = 0U; i < result.count; ++i )
+    {
+        cleanup_buffer( buffers[ i ] );
+    }
+    free( buffers );
+    return result;
+}
+
+static ionized_queue_lock write_lock(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested,
+    bool const blocking
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return failed( EINVAL );
+    }
+    ionize_status const valid = plasma_properties_validator( requested );
+    if( 0 != valid )
+    {
+        return failed( valid );
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    bool const overwrite =
+        ( 0U != ( state->config.flags & PLASMA_CONFIG_OVERWRITE ));
+    bool const latest =
+        ( 0U != ( state->config.flags & PLASMA_CONFIG_LATEST ));
+    size_t index = 0U;
+    bool waited = false;
+    for( ;; )
+    {
+        bool const scrub = state->reclamation.scrub;
+        bool any = false;
+        bool found = false;
+        slot * soiled = NULL; /* free, but not zeroed by a sweep yet */
+        slot * reclaim = NULL;
+        slot * oldest = NULL;
+        bool const full = !overwrite
+            && !latest
+            && ( 0U != state->watermark )
+            && ( state->watermark <= state->pending );
+        for( size_t i = 0U; ( i < state->length ) && !found; ++i )
+        {
+            index = ( state->cursor + i ) % state->length;
+            slot * const s = &( state->slots[ index ] );
+            if( !matches( s, requested ))
+            {
+                continue;
+            }
+            any = true;
+            bool const candidate = ( FREE == s->state ) && reusable( s );
+            found = candidate && !( scrub && s->dirty );
+            if( candidate && !found && ( NULL == soiled ))
+            {
+                soiled = s;
+            }
+            if(
+                ( RETAINED == s->state )
+                && reusable( s )
+                && (( NULL == reclaim ) || ( s->sequence < reclaim->sequence ))
+            )
+            {
+                reclaim = s;
+            }
+            /* other queues may read shared buffer, it can't be dropped */
+            if(
+                overwrite
+                && ( READABLE == s->state )
+                && ( NULL == s->share )
+                && ( 0U == s->pins )
+                && (( NULL == oldest ) || ( s->sequence < oldest->sequence ))
+            )
+            {
+                oldest = s;
+            }
+        }
+        if( !found && ( NULL != soiled ))
+        {
+            index = ( size_t ) ( soiled - state->slots );
+            found = true;
+        }
+        if( found && !full )
+        {
+            break;
+        }
+        /* retention yields to writers */
+        if(( NULL != reclaim ) && !full )
+        {
+            index = ( size_t ) ( reclaim - state->slots );
+            break;
+        }
+        /* readers never see a dropped buffer, they hold no lock on it */
+        if( NULL != oldest )
+        {
+            index = ( size_t ) ( oldest - state->slots );
+            state->pending -= oldest->buffer.size;
+            --( state->readable );
+            ++( state->drops );
+            if( prioritized( state ))
+            {
+                heap_remove( state, oldest );
+            }
+            make_free( state, oldest );
+            break;
+        }
+        /* starvation due to slow readers is counted apart */
+        if( any && !waited && ( found || ( NULL != reclaim )))
+        {
+            ++( state->write_backpressured );
+        }
+        else if( any && !waited )
+        {
+            if( blocking )
+            {
+                ++( state->write_waits );
+            }
+            else
+            {
+                ++( state->write_eagains );
+            }
+        }
+        if( !any || !blocking )
+        {
+            UNUSED( pthread_mutex_unlock( &( state->mutex )));
+            return failed( any ? EAGAIN : ENOENT );
+        }
+        waited = true;
+        UNUSED( pthread_cond_wait( &( state->changed ), &( state->mutex )));
+    }
+
+    slot * const s = &( state->slots[ index ] );
+    bool const zero = state->reclamation.scrub && s->dirty;
+    state->scrubbed_inline += zero ? 1U : 0U;
+    s->dirty = false;
+    take_free( state );
+    s->state = WRITING;
+    s->leased = ionize_time();
+    s->committed = 0U;
+    s->tag = ( plasma_tag ) { 0U, 0U };
+    s->stamps = ( ionized_latency_stamps ) { 0U, 0U, 0U };
+    if( ionized_latency_sample( &( state->latency )))
+    {
+        s->stamps.write_lock = ionize_time();
+    }
+    if( 0U != reserved( state->config ))
+    {
+        plasma_header_stamp_lock(( plasma_header * ) s->buffer.memory, client );
+    }
+    state->cursor = index + 1U;
+    notify( state );
+    ionized_queue_lock const result = locked( state, index, s->size );
+    uint8_t * const data = s->data;
+    size_t const size = s->size;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    /* the buffer is ours already, zeroing it doesn't hold anyone back */
+    if( zero )
+    {
+        memset( data, 0, size );
+    }
+    return result;
+}
+
+static ionized_queue_lock read_lock(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested,
+    bool const blocking
+)
+{
+    UNUSED( client );
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return failed( EINVAL );
+    }
+    ionize_status const valid = plasma_properties_validator( requested );
+    if( 0 != valid )
+    {
+        return failed( valid );
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    bool const latest =
+        ( 0U != ( state->config.flags & PLASMA_CONFIG_LATEST ));
+    slot * chosen = NULL;
+    for( ;; )
+    {
+        /* most urgent buffer usually matches, else fall back to search */
+        if(
+            prioritized( state )
+            && ( 0U < state->heaped )
+            && matches( &( state->slots[ state->heap[ 0 ]] ), requested )
+        )
+        {
+            chosen = &( state->slots[ state->heap[ 0 ]] );
+            break;
+        }
+        bool any = false;
+        for( size_t i = 0U; i < state->length; ++i )
+        {
+            slot * const s = &( state->slots[ i ] );
+            if( !matches( s, requested ))
+            {
+                continue;
+            }
+            any = true;
+            /* latest buffer may already be shared by other readers */
+            if( latest && ( 0U != s->sequence )
+                && ( s->sequence == state->sequence )
+                && (( READABLE == s->state ) || ( READING == s->state )))
+            {
+                chosen = s;
+            }
+            else if(
+                !latest
+                && ( READABLE == s->state )
+                && (( NULL == chosen ) || before( state, s, chosen ))
+            )
+            {
+                chosen = s;
+            }
+        }
+        if( NULL != chosen )
+        {
+            break;
+        }
+        if( !any || !blocking )
+        {
+            UNUSED( pthread_mutex_unlock( &( state->mutex )));
+            return failed( any ? EAGAIN : ENOENT );
+        }
+        UNUSED( pthread_cond_wait( &( state->changed ), &( state->mutex )));
+    }
+
+    if( READABLE == chosen->state )
+    {
+        if( prioritized( state ))
+        {
+            heap_remove( state, chosen );
+        }
+        chosen->state = READING;
+        chosen->leased = ionize_time();
+        --( state->readable );
+        notify( state );
+    }
+    ++( chosen->readers );
+    if(( 0U != chosen->stamps.commit ) && ( 0U == chosen->stamps.read_lock ))
+    {
+        chosen->stamps.read_lock = ionize_time();
+        ionized_latency_record(
+            &( state->latency ),
+            IONIZED_LATENCY_QUEUEING,
+            chosen->stamps.commit,
+            chosen->stamps.read_lock
+        );
+    }
+    size_t const index = ( size_t ) ( chosen - state->slots );
+    ionized_queue_lock const result =
+        locked( state, index, chosen->committed );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return result;
+}
+
+static ionized_queue_lock replay_lock(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested,
+    uint64_t const sequence
+)
+{
+    UNUSED( client );
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return failed( EINVAL );
+    }
+    ionize_status const valid = plasma_properties_validator( requested );
+    if( 0 != valid )
+    {
+        return failed( valid );
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * chosen = NULL;
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        slot * const s = &( state->slots[ i ] );
+        if(
+            ( RETAINED == s->state )
+            && matches( s, requested )
+            && ( sequence <= s->sequence )
+            && (( NULL == chosen ) || ( s->sequence < chosen->sequence ))
+            && retains( state, s )
+        )
+        {
+            chosen = s;
+        }
+    }
+    if( NULL == chosen )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return failed( ENOENT );
+    }
+    ++( chosen->readers );
+    size_t const index = ( size_t ) ( chosen - state->slots );
+    ionized_queue_lock const result =
+        locked( state, index, chosen->committed );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return result;
+}
+
+/* slot must be locked for writing and length must fit */
+static leftover commit_locked(
+    ionized_queue_state * const state,
+    slot * const s,
+    size_t const length
+)
+{
+    leftover retired = nothing;
+    /* superseded buffer nobody reads is released, read ones on unlock */
+    if( 0U != ( state->config.flags & PLASMA_CONFIG_LATEST ))
+    {
+        for( size_t i = 0U; i < state->length; ++i )
+        {
+            slot * const other = &( state->slots[ i ] );
+            if( READABLE == other->state )
+            {
+                --( state->readable );
+                retired = release( state, other );
+            }
+        }
+    }
+    s->committed = length;
+    s->sequence = ++( state->sequence );
+    s->commit_time = ionize_time();
+    state->pending += s->buffer.size;
+    /* header of shared buffer describes it in the origin queue */
+    if(( 0U != reserved( state->config )) && !s->borrowed )
+    {
+        plasma_header_stamp_commit(
+            ( plasma_header * ) s->buffer.memory,
+            s->sequence,
+            length
+        );
+    }
+    if( 0U != s->stamps.write_lock )
+    {
+        s->stamps.commit = ionize_time();
+        ionized_latency_record(
+            &( state->latency ),
+            IONIZED_LATENCY_WRITE_HOLD,
+            s->stamps.write_lock,
+            s->stamps.commit
+        );
+    }
+    s->state = READABLE;
+    ++( state->readable );
+    if( prioritized( state ))
+    {
+        heap_push( state, s );
+    }
+    notify( state );
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    return retired;
+}
+
+/* first seal wins, flush racing the producer filling buffer changes nothing */
+static void seal( aggregate * const a, size_t const length )
+{
+    size_t expected = UNSEALED;
+    UNUSED( atomic_compare_exchange_strong(
+                &( a->length ),
+                &expected,
+                length
+    ));
+}
+
+/* commits sealed buffer once all its reservations are committed */
+static void complete( ionized_queue_state * const state, aggregate * const a )
+{
+    size_t const length = atomic_load( &( a->length ));
+    if(
+        ( UNSEALED == length )
+        || ( length != atomic_load( &( a->committed )))
+        || atomic_exchange( &( a->finished ), true )
+    )
+    {
+        return;
+    }
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    leftover const superseded =
+        commit_locked( state, &( state->slots[ a->index ] ), length );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    atomic_store( &( a->id ), 0U );
+    dispose( superseded );
+}
+
+static bool expired(
+    ionized_queue_state const * const state,
+    aggregate const * const a
+)
+{
+    return ( 0U != state->flush_timeout )
+        && ( 0U != atomic_load( &( a->reserved )))
+        && ( state->flush_timeout <= ionize_time() - a->opened );
+}
+
+/* seals non-empty buffer by reserving more than is left */
+static void flush_aggregate(
+    ionized_queue_state * const state,
+    aggregate * const a
+)
+{
+    if( 0U == atomic_load( &( a->reserved )))
+    {
+        return;
+    }
+    size_t const offset =
+        atomic_fetch_add( &( a->reserved ), a->capacity + 1U );
+    if( offset <= a->capacity )
+    {
+        seal( a, offset );
+    }
+    complete( state, a );
+}
+
+/* appending lock must be held, shared is enough */
+static ionized_queue_lock reserve(
+    ionized_queue_state * const state,
+    aggregate * const a,
+    size_t const length
+)
+{
+    size_t const offset = atomic_fetch_add( &( a->reserved ), length );
+    /* written so that huge lengths can't wrap around */
+    if(( offset <= a->capacity ) && ( length <= a->capacity - offset ))
+    {
+        if( length == a->capacity - offset )
+        {
+            seal( a, a->capacity );
+        }
+        return ( ionized_queue_lock )
+        {
+            .status = 0,
+            .hold = APPEND | atomic_load( &( a->id )),
+            .data = a->data + offset,
+            .size = length,
+            .fd = a->fd,
+            .offset = reserved( state->config ) + offset,
+            .sequence = 0U
+        };
+    }
+    /* the first reservation not fitting marks end of data */
+    if( offset <= a->capacity )
+    {
+        seal( a, offset );
+        complete( state, a );
+    }
+    return failed( EAGAIN );
+}
+
+/* appending lock must be held exclusively */
+static ionize_status open_aggregate(
+    ionized_queue * const self,
+    uint32_t const client,
+    size_t const length
+)
+{
+    ionized_queue_state * const state = self->state;
+    aggregate * const current = state->open;
+    if(( NULL != current ) && ( UNSEALED == atomic_load( &( current->length ))))
+    {
+        /* someone opened it meanwhile, unless it's been open too long */
+        if( !expired( state, current ))
+        {
+            return 0;
+        }
+        flush_aggregate( state, current );
+    }
+    state->open = NULL;
+
+    size_t entry = 0U;
+    while(
+        ( entry < state->aggregated )
+        && ( 0U != atomic_load( &( state->aggregates[ entry ].id )))
+    )
+    {
+        ++entry;
+    }
+    if( entry == state->aggregated )
+    {
+        aggregate * const aggregates = realloc(
+            state->aggregates,
+            ( state->aggregated + 1U ) * sizeof( aggregate )
+        );
+        if( NULL == aggregates )
+        {
+            return ENOMEM;
+        }
+        state->aggregates = aggregates;
+        atomic_init( &( aggregates[ state->aggregated++ ].id ), 0U );
+    }
+
+    plasma_properties const fitting = { length, SIZE_MAX, 1U };
+    ionized_queue_lock const lock =
+        self->write_lock( self, client, fitting, false );
+    if( 0 != lock.status )
+    {
+        return lock.status;
+    }
+    /* buffer stays locked while producers append, leases don't apply */
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * const s = held( state, lock.hold );
+    if( NULL != s )
+    {
+        s->leased = 0U;
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    if( NULL == s )
+    {
+        return ETIMEDOUT;
+    }
+    aggregate * const a = &( state->aggregates[ entry ] );
+    a->index = ( size_t ) ( lock.hold & INDEX );
+    a->data = lock.data;
+    a->fd = lock.fd;
+    a->capacity = lock.size;
+    a->opened = ionize_time();
+    atomic_init( &( a->reserved ), 0U );
+    atomic_init( &( a->committed ), 0U );
+    atomic_init( &( a->length ), UNSEALED );
+    atomic_init( &( a->finished ), false );
+    /* ids never repeat, so stale holds can't commit into new buffer */
+    atomic_store( &( a->id ), ++( state->appends ));
+    state->open = a;
+    return 0;
+}
+
+static ionized_queue_lock append(
+    ionized_queue * const self,
+    uint32_t const client,
+    size_t const length
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ) || ( 0U == length ))
+    {
+        return failed( EINVAL );
+    }
+
+    ionized_queue_state * const state = self->state;
+    for( ;; )
+    {
+        UNUSED( pthread_rwlock_rdlock( &( state->appending )));
+        aggregate * const a = state->open;
+        /* length past capacity would move the offset of every producer */
+        if(( NULL != a ) && ( a->capacity < length ))
+        {
+            UNUSED( pthread_rwlock_unlock( &( state->appending )));
+            return failed( ERANGE );
+        }
+        if(( NULL != a ) && !expired( state, a ))
+        {
+            ionized_queue_lock const lock = reserve( state, a, length );
+            if( 0 == lock.status )
+            {
+                UNUSED( pthread_rwlock_unlock( &( state->appending )));
+                return lock;
+            }
+        }
+        UNUSED( pthread_rwlock_unlock( &( state->appending )));
+
+        /* buffer is full, expired or there's none: open next one */
+        UNUSED( pthread_rwlock_wrlock( &( state->appending )));
+        ionize_status const result = open_aggregate( self, client, length );
+        UNUSED( pthread_rwlock_unlock( &( state->appending )));
+        if( 0 != result )
+        {
+            return failed( result );
+        }
+    }
+}
+
+static ionize_status append_commit(
+    ionized_queue_state * const state,
+    uint64_t const id,
+    size_t const length
+)
+{
+    ionize_status result = EPERM;
+    UNUSED( pthread_rwlock_rdlock( &( state->appending )));
+    for( size_t i = 0U; ( i < state->aggregated ) && ( 0 != result ); ++i )
+    {
+        aggregate * const a = &( state->aggregates[ i ] );
+        if(( 0U == id ) || ( id != atomic_load( &( a->id ))))
+        {
+            continue;
+        }
+        result = 0;
+        UNUSED( atomic_fetch_add( &( a->committed ), length ));
+        if( expired( state, a ))
+        {
+            flush_aggregate( state, a );
+        }
+        complete( state, a );
+    }
+    UNUSED( pthread_rwlock_unlock( &( state->appending )));
+    return result;
+}
+
+static ionize_status flush( ionized_queue * const self, bool const force )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_rwlock_rdlock( &( state->appending )));
+    aggregate * const a = state->open;
+    if(( NULL != a ) && ( force || expired( state, a )))
+    {
+        flush_aggregate( state, a );
+    }
+    UNUSED( pthread_rwlock_unlock( &( state->appending )));
+    return 0;
+}
+
+static ionize_status
+flush_timeout( ionized_queue * const self, uint64_t const timeout )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_rwlock_wrlock( &( state->appending )));
+    state->flush_timeout = timeout;
+    UNUSED( pthread_rwlock_unlock( &( state->appending )));
+    return 0;
+}
+
+static ionize_status commit(
+    ionized_queue * const self,
+    uint64_t const hold,
+    size_t const length
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+    if( 0U != ( hold & APPEND ))
+    {
+        return append_commit( self->state, hold & ~APPEND, length );
+    }
+
+    ionized_queue_state * const state = self->state;
+    leftover retired = nothing;
+    ionize_status result = 0;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * const s = held( state, hold );
+    if( NULL == s )
+    {
+        result = rejected( state, hold );
+    }
+    else if( WRITING != s->state )
+    {
+        result = EPERM;
+    }
+    else if( s->size < length )
+    {
+        result = ERANGE;
+    }
+    else
+    {
+        retired = commit_locked( state, s, length );
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    dispose( retired );
+    return result;
+}
+
+static ionize_status unlock( ionized_queue * const self, uint64_t const hold )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    leftover retired = nothing;
+    ionize_status result = 0;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    bool const snapshot = ( 0U != ( hold & SNAPSHOT ));
+    /* pins aren't leased, they're found by id, released once */
+    slot * s = NULL;
+    for( size_t i = 0U; snapshot && ( i < state->snapshotted ); ++i )
+    {
+        if(( hold & ~SNAPSHOT ) == state->snapshots[ i ].id )
+        {
+            s = &( state->slots[ state->snapshots[ i ].index ] );
+            state->snapshots[ i ] =
+                state->snapshots[ --( state->snapshotted ) ];
+            break;
+        }
+    }
+    s = snapshot ? s : held( state, hold );
+    if(( NULL != s ) && snapshot )
+    {
+        /* writers may be waiting for the last pinned buffer */
+        if( 0U == --( s->pins ))
+        {
+            if(( 0U < state->retiring ) && reusable( s ))
+            {
+                --( state->retiring );
+                retired.buffer = retire( state, s );
+                notify( state );
+            }
+            UNUSED( pthread_cond_broadcast( &( state->changed )));
+        }
+    }
+    else if(( NULL != s ) && ( WRITING == s->state ))
+    {
+        retired = commit_locked( state, s, s->size );
+    }
+    else if(( NULL != s ) && ( READING == s->state ))
+    {
+        if( 0U == --( s->readers ))
+        {
+            ionized_latency_record(
+                &( state->latency ),
+                IONIZED_LATENCY_READ_HOLD,
+                s->stamps.read_lock,
+                ionize_time()
+            );
+            retired = consumed( state, s );
+        }
+    }
+    else if(( NULL != s ) && ( RETAINED == s->state ) && ( 0U < s->readers ))
+    {
+        /* writers may be waiting for the last retained buffer */
+        if( 0U == --( s->readers ))
+        {
+            UNUSED( pthread_cond_broadcast( &( state->changed )));
+        }
+    }
+    else
+    {
+        result = ( NULL == s ) ? rejected( state, hold ) : EPERM;
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    dispose( retired );
+    return result;
+}
+
+static ionize_status abandon(
+    ionized_queue * const self,
+    uint64_t const hold,
+    size_t const length
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+    /* other producers' data in the buffer waits for this range */
+    if( 0U != ( hold & APPEND ))
+    {
+        return append_commit( self->state, hold & ~APPEND, length );
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * const s = ( 0U == ( hold & SNAPSHOT )) ? held( state, hold ) : NULL;
+    if(( NULL == s ) || ( WRITING != s->state ))
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return unlock( self, hold );
+    }
+    ionized_buffer const retired = discard( state, s );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    dispose(( leftover ) { retired, NULL });
+    return 0;
+}
+
+static ionize_status lease( ionized_queue * const self, uint64_t const lease )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    state->lease = lease;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+static bool overdue(
+    ionized_queue_state const * const state,
+    slot const * const s,
+    uint64_t const now
+)
+{
+    return ( 0U != state->lease )
+        && ( 0U != s->leased )
+        && (( WRITING == s->state ) || ( READING == s->state ))
+        && ( state->lease <= now - s->leased );
+}
+
+static ionize_status expire( ionized_queue * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    uint64_t const now = ionize_time();
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        slot * const s = &( state->slots[ i ] );
+        if( !overdue( state, s, now ))
+        {
+            continue;
+        }
+        /* readers share the hold, so there's no telling the overdue one
+         * apart, every holder of the buffer loses it */
+        s->generation = ( s->generation + 1U ) % GENERATIONS;
+        s->leased = 0U;
+        ++( state->revoked );
+        bool const writing = ( WRITING == s->state );
+        leftover retired = nothing;
+        if( writing )
+        {
+            retired.buffer = discard( state, s );
+        }
+        else
+        {
+            s->readers = 0U;
+            retired = consumed( state, s );
+        }
+        /* slots may be reallocated meanwhile, the loop indexes them anew */
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        dispose( retired );
+        IONIZE_WARNING(
+            "queue %"PRIu32" revoked %s lock of buffer %zu",
+            state->uid,
+            writing ? "write" : "read",
+            i
+        );
+        UNUSED( pthread_mutex_lock( &( state->mutex )));
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+static ionize_status
+backpressure( ionized_queue * const self, size_t const watermark )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    state->watermark = watermark;
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+static ionize_status tag(
+    ionized_queue * const self,
+    uint64_t const hold,
+    plasma_tag const tag
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    ionize_status result = 0;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * const s = held( state, hold );
+    if( NULL == s )
+    {
+        result = rejected( state, hold );
+    }
+    else if( WRITING != s->state )
+    {
+        result = EPERM;
+    }
+    else
+    {
+        s->tag = tag;
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return result;
+}
+
+static ionized_queue_lock snapshot_lock(
+    ionized_queue * const self,
+    uint32_t const client,
+    plasma_properties const requested
+)
+{
+    UNUSED( client );
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return failed( EINVAL );
+    }
+    ionize_status const valid = plasma_properties_validator( requested );
+    if( 0 != valid )
+    {
+        return failed( valid );
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * chosen = NULL;
+    bool any = false;
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        slot * const s = &( state->slots[ i ] );
+        if( !matches( s, requested ) || s->borrowed )
+        {
+            continue;
+        }
+        any = true;
+        /* buffers committed at some point and not rewritten since */
+        if(
+            ( WRITING != s->state )
+            && ( 0U != s->sequence )
+            && (( NULL == chosen ) || ( chosen->sequence < s->sequence ))
+        )
+        {
+            chosen = s;
+        }
+    }
+    if( NULL == chosen )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return failed( any ? EAGAIN : ENOENT );
+    }
+    pin * const snapshots = realloc(
+        state->snapshots,
+        ( state->snapshotted + 1U ) * sizeof( pin )
+    );
+    if( NULL == snapshots )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return failed( ENOMEM );
+    }
+    state->snapshots = snapshots;
+    ++( chosen->pins );
+    size_t const index = ( size_t ) ( chosen - state->slots );
+    snapshots[ state->snapshotted++ ] = ( pin ) { ++( state->pinned ), index };
+    ionized_queue_lock result = locked( state, index, chosen->committed );
+    result.hold = SNAPSHOT | state->pinned;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return result;
+}
+
+static ionize_status retention(
+    ionized_queue * const self,
+    ionized_queue_retention const policy
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    state->retention = policy;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+static ionize_status reclamation(
+    ionized_queue * const self,
+    ionized_queue_reclamation const policy
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    state->reclamation = policy;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return 0;
+}
+
+/* whether the sweep has work with the buffer, mutex must be held */
+static swept sweepable(
+    ionized_queue_state const * const state,
+    size_t const index,
+    uint64_t const now,
+    bool const forced
+)
+{
+    ionized_queue_reclamation const policy = state->reclamation;
+    slot const * const s = &( state->slots[ index ] );
+    swept result =
+    {
+        .index = index,
+        .buffer = s->buffer,
+        .header = reserved( state->config ),
+        .zero = false,
+        .release = false
+    };
+    /* writers skip pinned buffers, so sweeps never share them */
+    if(( FREE != s->state ) || ( 0U != s->pins ))
+    {
+        return result;
+    }
+    result.zero = policy.scrub && s->dirty;
+    /* populated buffers stay so, they're kept off the fault path for good */
+    uint32_t const populated = IONIZED_BUFFER_PREFAULT | IONIZED_BUFFER_MLOCK;
+    result.release = !s->released
+        && ( 0U == ( s->backing & populated ))
+        && ( forced
+            || (( 0U != policy.idle ) && ( policy.idle <= now - s->freed )));
+    return result;
+}
+
+static void sweep_buffers( ionized_task * const task )
+{
+    sweep * const job = task->context;
+    ionized_queue_state * const state = job->state;
+    uint64_t reclaimed = 0U;
+    for( size_t i = 0U; i < job->count; ++i )
+    {
+        swept * const e = &( job->buffers[ i ] );
+        bool const released =
+            e->release && ( 0 == ionized_buffer_release( &( e->buffer )));
+        /* released pages read as zeroes already */
+        if( e->zero && !released )
+        {
+            uint8_t * const memory = e->buffer.memory;
+            memset( memory + e->header, 0, e->buffer.size - e->header );
+        }
+        reclaimed += released ? 1U : 0U;
+    }
+
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    for( size_t i = 0U; i < job->count; ++i )
+    {
+        swept * const e = &( job->buffers[ i ] );
+        slot * const s = &( state->slots[ e->index ] );
+        --( s->pins );
+        s->dirty = s->dirty && !e->zero;
+        /* failed release isn't retried until the buffer is reused */
+        s->released = s->released || e->release;
+        state->scrubbed += e->zero ? 1U : 0U;
+        e->buffer = nothing.buffer;
+        if(( 0U < state->retiring ) && reusable( s ))
+        {
+            --( state->retiring );
+            e->buffer = retire( state, s );
+        }
+    }
+    state->reclaimed += reclaimed;
+    --( state->sweeping );
+    notify( state );
+    UNUSED( pthread_cond_broadcast( &( state->changed )));
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    for( size_t i = 0U; i < job->count; ++i )
+    {
+        cleanup_buffer( job->buffers[ i ].buffer );
+    }
+    free( job );
+}
+
+/* forced sweep returns pages of all free buffers, whatever the policy */
+static ionize_status sweep_free(
+    ionized_queue_state * const state,
+    bool const forced
+)
+{
+    uint64_t const now = ionize_time();
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    size_t count = 0U;
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        swept const e = sweepable( state, i, now, forced );
+        count += ( e.zero || e.release ) ? 1U : 0U;
+    }
+    if( 0U == count )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return 0;
+    }
+    sweep * const job = malloc( sizeof( sweep ) + count * sizeof( swept ));
+    if( NULL == job )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return ENOMEM;
+    }
+    job->state = state;
+    job->count = 0U;
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        swept const e = sweepable( state, i, now, forced );
+        if( e.zero || e.release )
+        {
+            slot * const s = &( state->slots[ i ] );
+            /* contents are going, snapshots can't take them as the latest */
+            s->sequence = 0U;
+            s->committed = 0U;
+            ++( s->pins );
+            job->buffers[ job->count++ ] = e;
+        }
+    }
+    ++( state->sweeping );
+    ionized_pool * const pool = state->pool;
+    size_t const producer = state->producer;
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    job->task = ( ionized_task ) { sweep_buffers, job };
+    if(
+        ( NULL == pool )
+        || ( 0 != pool->submit( pool, producer, &( job->task )))
+    )
+    {
+        sweep_buffers( &( job->task ));
+    }
+    return 0;
+}
+
+static ionize_status reclaim( ionized_queue * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+    return sweep_free( self->state, false );
+}
+
+static ionize_status trim( ionized_queue * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+    return sweep_free( self->state, true );
+}
+
+static ionized_queue_subscription
+subscribe( ionized_queue * const self, plasma_watermark const watermark )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return ( ionized_queue_subscription ) { EINVAL, -1 };
+    }
+    ionize_status const valid = plasma_watermark_validator( watermark );
+    if( 0 != valid )
+    {
+        return ( ionized_queue_subscription ) { valid, -1 };
+    }
+    int const fd = eventfd( 0U, EFD_NONBLOCK | EFD_CLOEXEC );
+    if( -1 == fd )
+    {
+        return ( ionized_queue_subscription ) { errno, -1 };
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    subscription * const subscriptions = realloc(
+        state->subscriptions,
+        ( state->subscribed + 1U ) * sizeof( subscription )
+    );
+    if( NULL == subscriptions )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        UNUSED( close( fd ));
+        return ( ionized_queue_subscription ) { ENOMEM, -1 };
+    }
+    state->subscriptions = subscriptions;
+    subscriptions[ state->subscribed++ ] =
+        ( subscription ) { watermark, fd, false };
+    notify( state );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    return ( ionized_queue_subscription ) { 0, fd };
+}
+
+static ionize_status unsubscribe( ionized_queue * const self, int const fd )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = self->state;
+    ionize_status result = ENOENT;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    for( size_t i = 0U; i < state->subscribed; ++i )
+    {
+        if( fd == state->subscriptions[ i ].fd )
+        {
+            state->subscriptions[ i ] =
+                state->subscriptions[ --( state->subscribed ) ];
+            result = 0;
+            break;
+        }
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    if( 0 == result )
+    {
+        UNUSED( close( fd ));
+    }
+    return result;
+}
+
+static ionized_queue_stats
+stats( ionized_queue * const self, bool const reset )
+{
+    ionized_queue_stats result;
+    memset( &result, 0, sizeof( ionized_queue_stats ));
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return result;
+    }
+
+    ionized_queue_state * const state = self->state;
+    uint64_t const now = ionize_time();
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    result.buffers = state->active;
+    result.populating = state->populating;
+    result.bytes = state->bytes;
+    result.free = state->free;
+    result.free_low = state->free_low;
+    result.write_waits = state->write_waits;
+    result.write_eagains = state->write_eagains;
+    result.write_backpressured = state->write_backpressured;
+    result.drops = state->drops;
+    result.revoked = state->revoked;
+    result.scrubbed = state->scrubbed;
+    result.scrubbed_inline = state->scrubbed_inline;
+    result.reclaimed = state->reclaimed;
+    result.properties = state->properties;
+    /* mincore takes long on large queues, it's asked once the mutex is free */
+    ionized_buffer * const buffers =
+        malloc( state->active * sizeof( ionized_buffer ));
+    size_t count = 0U;
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        slot const * const s = &( state->slots[ i ] );
+        if(( FREE == s->state ) && ( result.idle < now - s->freed ))
+        {
+            result.idle = now - s->freed;
+        }
+        /* borrowed buffers are counted by the queue owning them */
+        if(
+            ( NULL != buffers ) && ( count < state->active )
+            && ( RETIRED != s->state ) && !s->borrowed
+        )
+        {
+            buffers[ count++ ] = s->buffer;
+        }
+    }
+    if( reset )
+    {
+        state->free_low = state->free;
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+
+    /* buffers retired meanwhile are unmapped, mincore fails on them */
+    for( size_t i = 0U; i < count; ++i )
+    {
+        result.cold += ionized_buffer_cold( &( buffers[ i ] ));
+    }
+    free( buffers );
+    return result;
+}
+
+static ionized_latency_snapshot_result latency( ionized_queue * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return ( ionized_latency_snapshot_result ) { 0U, { { 0U } } };
+    }
+    return ionized_latency_snapshot( &( self->state->latency ));
+}
+
+/* charges or refunds memory of a buffer moving between queues */
+static ionize_status move_charge(
+    ionized_queue_state const * const from,
+    ionized_queue_state const * const to,
+    slot const * const s
+)
+{
+    if( NULL != to->quota )
+    {
+        ionize_status const result =
+            to->quota->charge( to->quota, to->uid, s->owner, s->buffer.size );
+        if( 0 != result )
+        {
+            return result;
+        }
+    }
+    if( NULL != from->quota )
+    {
+        UNUSED( from->quota->refund(
+            from->quota,
+            from->uid,
+            s->owner,
+            s->buffer.size
+        ));
+    }
+    return 0;
+}
+
+ionize_status ionized_queue_transfer(
+    ionized_queue * const source,
+    uint64_t const hold,
+    ionized_queue * const target,
+    size_t const length
+)
+{
+    if(
+        ( NULL == source )
+        || ( NULL == source->state )
+        || ( NULL == target )
+        || ( NULL == target->state )
+        || ( source->state == target->state )
+    )
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const from = source->state;
+    ionized_queue_state * const to = target->state;
+    /* fixed locking order, so crossing transfers don't deadlock */
+    pthread_mutex_t * const first =
+        ( from < to ) ? &( from->mutex ) : &( to->mutex );
+    pthread_mutex_t * const second =
+        ( from < to ) ? &( to->mutex ) : &( from->mutex );
+    UNUSED( pthread_mutex_lock( first ));
+    UNUSED( pthread_mutex_lock( second ));
+    if( reserved( from->config ) != reserved( to->config ))
+    {
+        UNUSED( pthread_mutex_unlock( second ));
+        UNUSED( pthread_mutex_unlock( first ));
+        return EINVAL;
+    }
+    slot * const s = held( from, hold );
+    if(
+        ( NULL == s )
+        || ( READING != s->state )
+        || ( 1U != s->readers )
+        || ( NULL != s->share )
+        || ( 0U != s->pins )
+    )
+    {
+        ionize_status const result =
+            ( NULL == s ) ? rejected( from, hold ) : EPERM;
+        UNUSED( pthread_mutex_unlock( second ));
+        UNUSED( pthread_mutex_unlock( first ));
+        return result;
+    }
+
+    slot * t = NULL;
+    for( size_t i = 0U; ( i < to->length ) && ( NULL == t ); ++i )
+    {
+        if( reusable( &( to->slots[ i ] )))
+        {
+            t = &( to->slots[ i ] );
+        }
+    }
+    ionize_status result = 0;
+    if( s->size < length )
+    {
+        result = ERANGE;
+    }
+    else if( NULL == t )
+    {
+        result = EAGAIN;
+    }
+    if( 0 == result )
+    {
+        result = move_charge( from, to, s );
+    }
+    if( 0 == result )
+    {
+        result = move_charge( to, from, t );
+        if( 0 != result )
+        {
+            UNUSED( move_charge( to, from, s ));
+        }
+    }
+
+    leftover retired = nothing;
+    leftover superseded = nothing;
+    ionized_latency_record(
+        &( from->latency ),
+        IONIZED_LATENCY_READ_HOLD,
+        s->stamps.read_lock,
+        ionize_time()
+    );
+    if( 0 == result )
+    {
+        /* slots keep their place in queues, buffers change hands */
+        slot const moved = *s;
+        from->pending -= s->buffer.size;
+        from->bytes += t->buffer.size - s->buffer.size;
+        to->bytes += s->buffer.size - t->buffer.size;
+        s->buffer = t->buffer;
+        s->data = t->data;
+        s->size = t->size;
+        s->owner = t->owner;
+        s->backing = t->backing;
+        s->readers = 0U;
+        s->sequence = 0U;
+        /* buffer from target holds nothing worth retaining */
+        if( 0U < from->retiring )
+        {
+            --( from->retiring );
+            retired.buffer = retire( from, s );
+        }
+        else
+        {
+            make_free( from, s );
+        }
+
+        take_free( to );
+        t->buffer = moved.buffer;
+        t->data = moved.data;
+        t->size = moved.size;
+        t->owner = moved.owner;
+        t->backing = moved.backing;
+        t->tag = moved.tag;
+        t->readers = 0U;
+        t->stamps = ( ionized_latency_stamps ) { 0U, 0U, 0U };
+        t->state = WRITING;
+        superseded = commit_locked( to, t, length );
+    }
+    else
+    {
+        retired = release( from, s );
+    }
+    notify( from );
+    UNUSED( pthread_cond_broadcast( &( from->changed )));
+    UNUSED( pthread_mutex_unlock( second ));
+    UNUSED( pthread_mutex_unlock( first ));
+    dispose( retired );
+    dispose( superseded );
+    return result;
+}
+
+/* returns index of unused entry, state->length if none could be made */
+static size_t spare( ionized_queue_state * const state )
+{
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        if( RETIRED == state->slots[ i ].state )
+        {
+            return i;
+        }
+    }
+    slot * const slots =
+        realloc( state->slots, ( state->length + 1U ) * sizeof( slot ));
+    if( NULL == slots )
+    {
+        return state->length;
+    }
+    state->slots = slots;
+    memset( &( slots[ state->length ] ), 0, sizeof( slot ));
+    slots[ state->length ].state = RETIRED;
+    slots[ state->length ].buffer.fd = -1;
+    size_t const index = state->length++;
+    return fit_heap( state ) ? index : state->length;
+}
+
+/* places a reference to shared buffer in target queue as committed buffer */
+static ionize_status borrow(
+    ionized_queue_state * const state,
+    slot const * const origin,
+    size_t const length
+)
+{
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    if( reserved( state->config ) != reserved( origin->share->origin->config ))
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return EINVAL;
+    }
+    size_t const index = spare( state );
+    if( index == state->length )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return ENOMEM;
+    }
+    slot * const s = &( state->slots[ index ] );
+    s->buffer = origin->buffer;
+    s->data = origin->data;
+    s->size = origin->size;
+    s->owner = origin->owner;
+    s->backing = origin->backing;
+    s->share = origin->share;
+    s->borrowed = true;
+    s->tag = origin->tag;
+    s->state = WRITING;
+    ++( state->borrowed );
+    leftover const superseded = commit_locked( state, s, length );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    dispose( superseded );
+    return 0;
+}
+
+ionize_status ionized_queue_publish(
+    ionized_queue * const self,
+    uint64_t const hold,
+    ionized_queue * const * const targets,
+    size_t const count,
+    size_t const length
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ) || ( NULL == targets ))
+    {
+        return EINVAL;
+    }
+    for( size_t i = 0U; i < count; ++i )
+    {
+        if(
+            ( NULL == targets[ i ] )
+            || ( NULL == targets[ i ]->state )
+            || ( self->state == targets[ i ]->state )
+        )
+        {
+            return EINVAL;
+        }
+    }
+
+    ionized_queue_state * const state = self->state;
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    slot * const s = held( state, hold );
+    ionize_status result = 0;
+    if( NULL == s )
+    {
+        result = rejected( state, hold );
+    }
+    else if( WRITING != s->state )
+    {
+        result = EPERM;
+    }
+    else if( s->size < length )
+    {
+        result = ERANGE;
+    }
+    else if( NULL == ( s->share = malloc( sizeof( share ))))
+    {
+        result = ENOMEM;
+    }
+    if( 0 != result )
+    {
+        UNUSED( pthread_mutex_unlock( &( state->mutex )));
+        return result;
+    }
+    /* reference held by origin is dropped when it consumes the buffer */
+    share * const shared = s->share;
+    atomic_init( &( shared->references ), count + 1U );
+    shared->origin = state;
+    shared->index = ( size_t ) ( s - state->slots );
+    slot const published = *s;
+    leftover const superseded = commit_locked( state, s, length );
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    dispose( superseded );
+
+    /* origin can't recycle the buffer before every target dropped it */
+    for( size_t i = 0U; i < count; ++i )
+    {
+        ionize_status const borrowed =
+            borrow( targets[ i ]->state, &published, length );
+        if( 0 == borrowed )
+        {
+            continue;
+        }
+        if( 0 == result )
+        {
+            result = borrowed;
+        }
+        if( 1U == atomic_fetch_sub( &( shared->references ), 1U ))
+        {
+            finish( shared );
+        }
+    }
+    return result;
+}
+
+ionized_queue_setup_result ionized_queue_setup(
+    uint32_t const uid,
+    uint32_t const sampling,
+    ionized_quota * const quota
+)
+{
+    ionized_queue_setup_result result =
+    {
+        .status = 0,
+        .queue =
+        {
+            .state = NULL,
+            .configure = configure,
+            .allocate = allocate,
+            .backing = backing,
+            .offload = offload,
+            .shrink = shrink,
+            .prune = prune,
+            .read_lock = read_lock,
+            .write_lock = write_lock,
+            .replay_lock = replay_lock,
+            .snapshot_lock = snapshot_lock,
+            .commit = commit,
+            .tag = tag,
+            .append = append,
+            .flush = flush,
+            .flush_timeout = flush_timeout,
+            .unlock = unlock,
+            .abandon = abandon,
+            .lease = lease,
+            .expire = expire,
+            .latency = latency,
+            .stats = stats,
+            .backpressure = backpressure,
+            .subscribe = subscribe,
+            .unsubscribe = unsubscribe,
+            .retention = retention,
+            .reclamation = reclamation,
+            .reclaim = reclaim,
+            .trim = trim
+        }
+    };
+
+    ionized_queue_state * const state = malloc( sizeof( ionized_queue_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memset( state, 0, sizeof( ionized_queue_state ));
+    state->uid = uid;
+    state->quota = quota;
+
+    result.status = ionized_latency_init( &( state->latency ), sampling );
+    if( 0 != result.status )
+    {
+        free( state );
+        return result;
+    }
+    if( 0 != pthread_mutex_init( &( state->mutex ), NULL ))
+    {
+        free( state );
+        result.status = EIO;
+        return result;
+    }
+    if( 0 != pthread_cond_init( &( state->changed ), NULL ))
+    {
+        UNUSED( pthread_mutex_destroy( &( state->mutex )));
+        free( state );
+        result.status = EIO;
+        return result;
+    }
+    if( 0 != pthread_rwlock_init( &( state->appending ), NULL ))
+    {
+        UNUSED( pthread_cond_destroy( &( state->changed )));
+        UNUSED( pthread_mutex_destroy( &( state->mutex )));
+        free( state );
+        result.status = EIO;
+        return result;
+    }
+
+    result.queue.state = state;
+    return result;
+}
+
+ionize_status ionized_queue_cleanup( ionized_queue * const queue )
+{
+    if(( NULL == queue ) || ( NULL == queue->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_queue_state * const state = queue->state;
+    /* sweeps and populations running on the pool still use the state */
+    UNUSED( pthread_mutex_lock( &( state->mutex )));
+    while(( 0U < state->sweeping ) || ( 0U < state->populating ))
+    {
+        UNUSED( pthread_cond_wait( &( state->changed ), &( state->mutex )));
+    }
+    UNUSED( pthread_mutex_unlock( &( state->mutex )));
+    ionize_status result = 0;
+    for( size_t i = 0U; i < state->length; ++i )
+    {
+        slot * const s = &( state->slots[ i ] );
+        if( RETIRED == s->state )
+        {
+            continue;
+        }
+        /* borrowed memory belongs to the origin, which may recycle it now */
+        if( s->borrowed )
+        {
+            if( 1U == atomic_fetch_sub( &( s->share->references ), 1U ))
+            {
+                finish( s->share );
+            }
+            continue;
+        }
+        if(
+            ( NULL != s->share )
+            && ( LENT != s->state )
+            && ( 1U == atomic_fetch_sub( &( s->share->references ), 1U ))
+        )
+        {
+            free( s->share );
+        }
+        ionized_buffer buffer = retire( state, s );
+        if( 0 != ionized_buffer_cleanup( &buffer ))
+        {
+            result = EIO;
+        }
+    }
+    free( state->slots );
+    for( size_t i = 0U; i < state->subscribed; ++i )
+    {
+        UNUSED( close( state->subscriptions[ i ].fd ));
+    }
+    free( state->subscriptions );
+    free( state->heap );
+    free( state->aggregates );
+    free( state->snapshots );
+    if(( 0 != pthread_rwlock_destroy( &( state->appending )))
+        || ( 0 != pthread_cond_destroy( &( state->changed )))
+        || ( 0 != pthread_mutex_destroy( &( state->mutex ))))
+    {
+        result = EIO;
+    }
+    free( state );
+    queue->state = NULL;
+    return result;
+}
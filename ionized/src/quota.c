@@ -0,0 +1,333 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of memory budget methods.
+ * \date        10/20/2026 11:41:26 AM
+ * \file        quota.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* EDQUOT, EEXIST, EINVAL, ENODATA, ENOMEM */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/mutex.h> /* ionize_mutex */
+#include <ionize/pointer_list.h> /* ionize_pointer_list */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/quota.h>
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint32_t */
+#include <stdlib.h> /* free, malloc */
+
+typedef struct
+{
+    ionized_quota_kind kind;
+    uint32_t id;
+    size_t limit; /* zero means default */
+    size_t used;
+}
+entry;
+
+struct ionized_quota_state_struct
+{
+    size_t defaults[ IONIZED_QUOTA_CLIENT + 1 ];
+    ionize_pointer_list entries;
+    ionize_mutex mutex;
+};
+
+/* kind and id are what we search for, found is the result */
+typedef struct
+{
+    ionized_quota_kind kind;
+    uint32_t id;
+    entry * found;
+}
+search_userdata;
+
+static ionize_status
+search_callback( void * const pointer, void * const userdata )
+{
+    entry * const e = pointer;
+    search_userdata * const data = userdata;
+
+    if(( e->kind == data->kind ) && ( e->id == data->id ))
+    {
+        data->found = e;
+        return EEXIST; /* stops iteration */
+    }
+    return 0;
+}
+
+static entry * find(
+    ionized_quota_state const * const state,
+    ionized_quota_kind const kind,
+    uint32_t const id
+)
+{
+    search_userdata data = { .kind = kind, .id = id, .found = NULL };
+    UNUSED( state->entries.foreach( state->entries, search_callback, &data ));
+    return data.found;
+}
+
+static entry * get(
+    ionized_quota_state * const state,
+    ionized_quota_kind const kind,
+    uint32_t const id
+)
+{
+    entry * result = find( state, kind, id );
+    if( NULL != result )
+    {
+        return result;
+    }
+
+    result = malloc( sizeof( entry ));
+    if( NULL == result )
+    {
+        return NULL;
+    }
+    *result = ( entry ) { .kind = kind, .id = id, .limit = 0U, .used = 0U };
+    if( 0 != state->entries.add( &( state->entries ), result ))
+    {
+        free( result );
+        return NULL;
+    }
+    return result;
+}
+
+/* entries at defaults and without usage are forgotten */
+static void forget( ionized_quota_state * const state, entry * const e )
+{
+    if(( NULL != e ) && ( 0U == e->limit ) && ( 0U == e->used ))
+    {
+        UNUSED( state->entries.remove( &( state->entries ), e ));
+        free( e );
+    }
+}
+
+static bool fits(
+    ionized_quota_state const * const state,
+    entry const * const e,
+    size_t const bytes
+)
+{
+    if( NULL == e )
+    {
+        return true;
+    }
+    size_t const limit =
+        ( 0U == e->limit ) ? state->defaults[ e->kind ] : e->limit;
+    return ( 0U == limit )
+        || (( e->used <= limit ) && ( bytes <= limit - e->used ));
+}
+
+static bool valid( ionized_quota const * const self )
+{
+    return ( NULL != self ) && ( NULL != self->state );
+}
+
+static ionize_status set(
+    ionized_quota * const self,
+    ionized_quota_kind const kind,
+    uint32_t const id,
+    size_t const limit
+)
+{
+    if( !valid( self ) || ( IONIZED_QUOTA_CLIENT < kind ))
+    {
+        return EINVAL;
+    }
+
+    ionized_quota_state * const state = self->state;
+    ionize_status result = state->mutex.lock( state->mutex );
+    if( 0 != result )
+    {
+        return result;
+    }
+    entry * const e = get( state, kind, id );
+    if( NULL == e )
+    {
+        result = ENOMEM;
+    }
+    else
+    {
+        e->limit = limit;
+        forget( state, e );
+    }
+    UNUSED( state->mutex.unlock( state->mutex ));
+    return result;
+}
+
+static ionize_status charge(
+    ionized_quota * const self,
+    uint32_t const uid,
+    uint32_t const client,
+    size_t const bytes
+)
+{
+    if( !valid( self ))
+    {
+        return EINVAL;
+    }
+
+    ionized_quota_state * const state = self->state;
+    ionize_status result = state->mutex.lock( state->mutex );
+    if( 0 != result )
+    {
+        return result;
+    }
+    entry * const queue = get( state, IONIZED_QUOTA_UID, uid );
+    entry * const owner = ( IONIZED_QUOTA_DAEMON == client )
+        ? NULL
+        : get( state, IONIZED_QUOTA_CLIENT, client );
+    if(
+        ( NULL == queue )
+        || (( IONIZED_QUOTA_DAEMON != client ) && ( NULL == owner ))
+    )
+    {
+        result = ENOMEM;
+    }
+    else if( !fits( state, queue, bytes ) || !fits( state, owner, bytes ))
+    {
+        result = EDQUOT;
+    }
+    else
+    {
+        queue->used += bytes;
+        if( NULL != owner )
+        {
+            owner->used += bytes;
+        }
+    }
+    forget( state, queue );
+    forget( state, owner );
+    UNUSED( state->mutex.unlock( state->mutex ));
+    return result;
+}
+
+static ionize_status refund(
+    ionized_quota * const self,
+    uint32_t const uid,
+    uint32_t const client,
+    size_t const bytes
+)
+{
+    if( !valid( self ))
+    {
+        return EINVAL;
+    }
+
+    ionized_quota_state * const state = self->state;
+    ionize_status const result = state->mutex.lock( state->mutex );
+    if( 0 != result )
+    {
+        return result;
+    }
+    entry * const queue = find( state, IONIZED_QUOTA_UID, uid );
+    entry * const owner = ( IONIZED_QUOTA_DAEMON == client )
+        ? NULL
+        : find( state, IONIZED_QUOTA_CLIENT, client );
+    if( NULL != queue )
+    {
+        queue->used = ( bytes < queue->used ) ? queue->used - bytes : 0U;
+        forget( state, queue );
+    }
+    if( NULL != owner )
+    {
+        owner->used = ( bytes < owner->used ) ? owner->used - bytes : 0U;
+        forget( state, owner );
+    }
+    UNUSED( state->mutex.unlock( state->mutex ));
+    return 0;
+}
+
+static ionized_quota_usage usage(
+    ionized_quota * const self,
+    ionized_quota_kind const kind,
+    uint32_t const id
+)
+{
+    ionized_quota_usage result = { .status = 0, .used = 0U, .limit = 0U };
+    if( !valid( self ) || ( IONIZED_QUOTA_CLIENT < kind ))
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_quota_state * const state = self->state;
+    result.status = state->mutex.lock( state->mutex );
+    if( 0 != result.status )
+    {
+        return result;
+    }
+    entry const * const e = find( state, kind, id );
+    result.used = ( NULL == e ) ? 0U : e->used;
+    result.limit = (( NULL == e ) || ( 0U == e->limit ))
+        ? state->defaults[ kind ]
+        : e->limit;
+    UNUSED( state->mutex.unlock( state->mutex ));
+    return result;
+}
+
+ionized_quota_setup_result ionized_quota_setup(
+    size_t const uid,
+    size_t const client
+)
+{
+    ionized_quota_setup_result result =
+    {
+        .status = 0,
+        .quota =
+        {
+            .state = NULL,
+            .set = set,
+            .charge = charge,
+            .refund = refund,
+            .usage = usage
+        }
+    };
+
+    ionized_quota_state * const state = malloc( sizeof( ionized_quota_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    ionize_mutex_setup_result const mutex = ionize_mutex_setup();
+    if( 0 != mutex.status )
+    {
+        free( state );
+        result.status = mutex.status;
+        return result;
+    }
+    state->defaults[ IONIZED_QUOTA_UID ] = uid;
+    state->defaults[ IONIZED_QUOTA_CLIENT ] = client;
+    state->entries = ionize_pointer_list_setup();
+    state->mutex = mutex.mutex;
+    result.quota.state = state;
+    return result;
+}
+
+static ionize_status
+free_callback( void * const pointer, void * const userdata )
+{
+    UNUSED( userdata );
+    free( pointer );
+    return 0;
+}
+
+ionize_status ionized_quota_cleanup( ionized_quota * const quota )
+{
+    if( !valid( quota ))
+    {
+        return EINVAL;
+    }
+
+    ionized_quota_state * const state = quota->state;
+    UNUSED( state->entries.foreach( state->entries, free_callback, NULL ));
+    UNUSED( ionize_pointer_list_cleanup( &( state->entries )));
+    ionize_status const result = ionize_mutex_cleanup( &( state->mutex ));
+    free( state );
+    quota->state = NULL;
+    return result;
+}
@@ -0,0 +1,367 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of reaper methods.
+ * \date        10/23/2026 10:05:16 AM
+ * \file        reaper.c
+ * \version     1.0
+ *
+ * Each pidfd is wrapped in a filament, readable once the process exits, so
+ * the event loop watches it like any client connection.
+ **/
+
+#define _GNU_SOURCE /* for syscall */
+
+#include <errno.h> /* EAGAIN, ECONNRESET, EEXIST, EINVAL, EIO, ENOMEM */
+#include <filament/filament.h> /* filament, filament_rx */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/log.h> /* IONIZE_INFO, IONIZE_WARNING */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/loop.h> /* ionized_loop */
+#include <ionized/queue.h> /* ionized_queue */
+#include <ionized/reaper.h>
+#include <poll.h> /* poll, POLLIN */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint32_t, uint64_t */
+#include <stdlib.h> /* free, malloc, realloc */
+#include <string.h> /* memset */
+#include <sys/syscall.h> /* SYS_pidfd_open */
+#include <sys/types.h> /* pid_t */
+#include <unistd.h> /* close, syscall */
+
+typedef struct
+{
+    ionized_queue * queue;
+    uint64_t hold;
+    size_t length;
+}
+lock;
+
+struct filament_state_struct
+{
+    int pidfd;
+};
+
+typedef struct
+{
+    ionized_reaper_state * reaper;
+    uint32_t client;
+    pid_t pid;
+    filament_state process;
+    filament endpoint; /* watched by the loop, so the record mustn't move */
+    lock * locks;
+    size_t held;
+}
+tracked;
+
+struct ionized_reaper_state_struct
+{
+    ionized_loop * loop;
+    tracked * * clients;
+    size_t count;
+    uint64_t reaped;
+    uint64_t abandoned;
+};
+
+static int fd( filament const * const self )
+{
+    return self->state->pidfd;
+}
+
+static filament_rx try_rx( filament const * const self )
+{
+    filament_rx result = { 0, { NULL, 0U } };
+    struct pollfd exited = { .fd = self->state->pidfd, .events = POLLIN };
+    int const ready = poll( &exited, 1U, 0 );
+    if( 0 > ready )
+    {
+        result.status = errno;
+    }
+    else
+    {
+        result.status = ( 0 == ready ) ? EAGAIN : ECONNRESET;
+    }
+    return result;
+}
+
+static tracked * find(
+    ionized_reaper_state const * const state,
+    uint32_t const client,
+    size_t * const position
+)
+{
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        if( client == state->clients[ i ]->client )
+        {
+            if( NULL != position )
+            {
+                *position = i;
+            }
+            return state->clients[ i ];
+        }
+    }
+    return NULL;
+}
+
+/* abandons all locks of the client and forgets it */
+static size_t reap( ionized_reaper_state * const state, tracked * const t )
+{
+    size_t const held = t->held;
+    for( size_t i = 0U; i < held; ++i )
+    {
+        ionized_queue * const q = t->locks[ i ].queue;
+        UNUSED( q->abandon( q, t->locks[ i ].hold, t->locks[ i ].length ));
+    }
+    state->abandoned += held;
+    UNUSED( state->loop->unwatch( state->loop, &( t->endpoint )));
+    UNUSED( close( t->process.pidfd ));
+    size_t position = 0U;
+    UNUSED( find( state, t->client, &position ));
+    state->clients[ position ] = state->clients[ --( state->count ) ];
+    free( t->locks );
+    free( t );
+    return held;
+}
+
+static ionize_status died(
+    void * const context,
+    filament const * const client,
+    filament_rx const rx
+)
+{
+    UNUSED( client );
+    tracked * const t = context;
+    if( EAGAIN == rx.status )
+    {
+        return 0;
+    }
+    ionized_reaper_state * const state = t->reaper;
+    uint32_t const id = t->client;
+    pid_t const pid = t->pid;
+    ++( state->reaped );
+    size_t const held = reap( state, t );
+    IONIZE_WARNING(
+        "client %"PRIu32" (pid %ld) died holding %zu locks",
+        id,
+        ( long ) pid,
+        held
+    );
+    return 0;
+}
+
+static ionize_status track(
+    ionized_reaper * const self,
+    uint32_t const client,
+    pid_t const pid
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_reaper_state * const state = self->state;
+    if( NULL != find( state, client, NULL ))
+    {
+        return EEXIST;
+    }
+    tracked * * const clients = realloc(
+        state->clients,
+        ( state->count + 1U ) * sizeof( tracked * )
+    );
+    if( NULL == clients )
+    {
+        return ENOMEM;
+    }
+    state->clients = clients;
+    tracked * const t = malloc( sizeof( tracked ));
+    if( NULL == t )
+    {
+        return ENOMEM;
+    }
+    int const pidfd = ( int ) syscall( SYS_pidfd_open, pid, 0U );
+    if( -1 == pidfd )
+    {
+        ionize_status const result = errno;
+        free( t );
+        return result;
+    }
+    *t = ( tracked )
+    {
+        .reaper = state,
+        .client = client,
+        .pid = pid,
+        .process = { .pidfd = pidfd },
+        .endpoint = { NULL, NULL, NULL, fd, try_rx },
+        .locks = NULL,
+        .held = 0U
+    };
+    t->endpoint.state = &( t->process );
+    ionize_status const result =
+        state->loop->watch( state->loop, &( t->endpoint ), died, t );
+    if( 0 != result )
+    {
+        UNUSED( close( pidfd ));
+        free( t );
+        return result;
+    }
+    clients[ state->count++ ] = t;
+    return 0;
+}
+
+static ionize_status hold(
+    ionized_reaper * const self,
+    uint32_t const client,
+    ionized_queue * const queue,
+    uint64_t const hold,
+    size_t const length
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ) || ( NULL == queue ))
+    {
+        return EINVAL;
+    }
+
+    tracked * const t = find( self->state, client, NULL );
+    if( NULL == t )
+    {
+        return ENOENT;
+    }
+    lock * const locks =
+        realloc( t->locks, ( t->held + 1U ) * sizeof( lock ));
+    if( NULL == locks )
+    {
+        return ENOMEM;
+    }
+    locks[ t->held++ ] = ( lock ) { queue, hold, length };
+    t->locks = locks;
+    return 0;
+}
+
+static ionize_status release(
+    ionized_reaper * const self,
+    uint32_t const client,
+    ionized_queue * const queue,
+    uint64_t const hold
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    tracked * const t = find( self->state, client, NULL );
+    if( NULL == t )
+    {
+        return ENOENT;
+    }
+    for( size_t i = 0U; i < t->held; ++i )
+    {
+        if(( queue == t->locks[ i ].queue ) && ( hold == t->locks[ i ].hold ))
+        {
+            t->locks[ i ] = t->locks[ --( t->held ) ];
+            return 0;
+        }
+    }
+    return ENOENT;
+}
+
+static ionize_status untrack(
+    ionized_reaper * const self,
+    uint32_t const client
+)
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    tracked * const t = find( self->state, client, NULL );
+    if( NULL == t )
+    {
+        return ENOENT;
+    }
+    size_t const held = reap( self->state, t );
+    if( 0U != held )
+    {
+        IONIZE_INFO(
+            "client %"PRIu32" disconnected holding %zu locks",
+            client,
+            held
+        );
+    }
+    return 0;
+}
+
+static ionized_reaper_stats stats( ionized_reaper const * const self )
+{
+    ionized_reaper_stats result = { 0U, 0U, 0U };
+    if(( NULL != self ) && ( NULL != self->state ))
+    {
+        result.reaped = self->state->reaped;
+        result.abandoned = self->state->abandoned;
+        result.tracked = self->state->count;
+    }
+    return result;
+}
+
+ionized_reaper_setup_result ionized_reaper_setup( ionized_loop * const loop )
+{
+    ionized_reaper_setup_result result =
+    {
+        .status = 0,
+        .reaper =
+        {
+            .state = NULL,
+            .track = track,
+            .hold = hold,
+            .release = release,
+            .untrack = untrack,
+            .stats = stats
+        }
+    };
+    if( NULL == loop )
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_reaper_state * const state =
+        malloc( sizeof( ionized_reaper_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memset( state, 0, sizeof( ionized_reaper_state ));
+    state->loop = loop;
+
+    result.reaper.state = state;
+    return result;
+}
+
+ionize_status ionized_reaper_cleanup( ionized_reaper * const reaper )
+{
+    if(( NULL == reaper ) || ( NULL == reaper->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_reaper_state * const state = reaper->state;
+    ionize_status result = 0;
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        tracked * const t = state->clients[ i ];
+        UNUSED( state->loop->unwatch( state->loop, &( t->endpoint )));
+        if( 0 != close( t->process.pidfd ))
+        {
+            result = EIO;
+        }
+        free( t->locks );
+        free( t );
+    }
+    free( state->clients );
+    free( state );
+    reaper->state = NULL;
+    return result;
+}
@@ -0,0 +1,360 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of shard methods.
+ * \date        10/21/2026 04:38:26 PM
+ * \file        shard.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#define _GNU_SOURCE /* for pthread_attr_setaffinity_np */
+
+#include <errno.h> /* EBUSY, EINVAL, ENOENT, ENOMEM, EXDEV */
+#include <ionize/error.h> /* ionize_status */
+#include <ionize/log.h> /* IONIZE_ERROR */
+#include <ionize/universal.h> /* UNUSED */
+#include <ionized/loop.h> /* ionized_loop */
+#include <ionized/queue.h> /* ionized_queue */
+#include <ionized/quota.h> /* ionized_quota */
+#include <ionized/reaper.h> /* ionized_reaper */
+#include <ionized/shard.h>
+#include <plasma/shard.h> /* plasma_shard */
+#include <pthread.h>
+#include <sched.h> /* cpu_set_t, CPU_SET, CPU_ZERO */
+#include <stdatomic.h> /* atomic_bool, atomic_load, atomic_store */
+#include <stdbool.h> /* bool */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint32_t */
+#include <stdlib.h> /* free, malloc, realloc */
+#include <string.h> /* memmove, memset */
+
+typedef struct
+{
+    uint32_t uid;
+    ionized_queue * queue; /* allocated, so it doesn't move with the table */
+}
+owned;
+
+struct ionized_shard_state_struct
+{
+    uint32_t index;
+    uint32_t shards;
+    int cpu;
+    uint32_t sampling;
+    ionized_quota * quota;
+    ionized_loop loop;
+    ionized_reaper reaper; /* watches pidfds with the loop */
+    owned * queues; /* sorted by uid */
+    size_t count;
+    pthread_t worker;
+    bool running;
+    atomic_bool stopping;
+};
+
+/* returns position of uid, or where it would be inserted */
+static size_t search( ionized_shard_state const * const state, uint32_t uid )
+{
+    size_t low = 0U;
+    size_t high = state->count;
+    while( low < high )
+    {
+        size_t const middle = low + ( high - low ) / 2U;
+        if( state->queues[ middle ].uid < uid )
+        {
+            low = middle + 1U;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static ionized_shard_queue_result queue(
+    ionized_shard * const self,
+    uint32_t const uid
+)
+{
+    ionized_shard_queue_result result = { .status = 0, .queue = NULL };
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_shard_state * const state = self->state;
+    if( state->index != plasma_shard( uid, state->shards ))
+    {
+        result.status = EXDEV;
+        return result;
+    }
+    size_t const position = search( state, uid );
+    if(( position < state->count ) && ( uid == state->queues[ position ].uid ))
+    {
+        result.queue = state->queues[ position ].queue;
+        return result;
+    }
+
+    owned * const queues =
+        realloc( state->queues, ( state->count + 1U ) * sizeof( owned ));
+    if( NULL == queues )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    state->queues = queues;
+    ionized_queue * const created = malloc( sizeof( ionized_queue ));
+    if( NULL == created )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    ionized_queue_setup_result const setup =
+        ionized_queue_setup( uid, state->sampling, state->quota );
+    if( 0 != setup.status )
+    {
+        free( created );
+        result.status = setup.status;
+        return result;
+    }
+    *created = setup.queue;
+    memmove(
+        &( queues[ position + 1U ] ),
+        &( queues[ position ] ),
+        ( state->count - position ) * sizeof( owned )
+    );
+    queues[ position ] = ( owned ) { .uid = uid, .queue = created };
+    ++( state->count );
+    result.queue = created;
+    return result;
+}
+
+static ionized_loop * loop( ionized_shard * const self )
+{
+    return (( NULL == self ) || ( NULL == self->state ))
+        ? NULL
+        : &( self->state->loop );
+}
+
+static ionized_reaper * reaper( ionized_shard * const self )
+{
+    return (( NULL == self ) || ( NULL == self->state ))
+        ? NULL
+        : &( self->state->reaper );
+}
+
+static void flush_all( ionized_shard_state * const state, bool const force )
+{
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        ionized_queue * const q = state->queues[ i ].queue;
+        UNUSED( q->flush( q, force ));
+    }
+}
+
+static void expire_all( ionized_shard_state * const state )
+{
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        ionized_queue * const q = state->queues[ i ].queue;
+        UNUSED( q->expire( q ));
+    }
+}
+
+static void reclaim_all( ionized_shard_state * const state )
+{
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        ionized_queue * const q = state->queues[ i ].queue;
+        UNUSED( q->reclaim( q ));
+    }
+}
+
+static void * work( void * const ptr )
+{
+    ionized_shard_state * const state = ptr;
+    while( !atomic_load( &( state->stopping )))
+    {
+        ionized_loop_run_result const run =
+            state->loop.run( &( state->loop ), IONIZED_SHARD_TICK );
+        if( 0 != run.status )
+        {
+            IONIZE_ERROR(
+                "shard %"PRIu32" loop failed: %d",
+                state->index,
+                run.status
+            );
+        }
+        flush_all( state, false );
+        expire_all( state );
+        reclaim_all( state );
+    }
+    flush_all( state, true );
+    return NULL;
+}
+
+static ionize_status start( ionized_shard * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_shard_state * const state = self->state;
+    if( state->running )
+    {
+        return EBUSY;
+    }
+    atomic_store( &( state->stopping ), false );
+    pthread_attr_t attr;
+    ionize_status result = pthread_attr_init( &attr );
+    if( 0 != result )
+    {
+        return result;
+    }
+    /* pinned before it runs, so no work starts on another core */
+    if( 0 <= state->cpu )
+    {
+        cpu_set_t cpus;
+        CPU_ZERO( &cpus );
+        CPU_SET( state->cpu, &cpus );
+        result = pthread_attr_setaffinity_np( &attr, sizeof( cpus ), &cpus );
+    }
+    if( 0 == result )
+    {
+        result = pthread_create( &( state->worker ), &attr, work, state );
+    }
+    UNUSED( pthread_attr_destroy( &attr ));
+    state->running = ( 0 == result );
+    return result;
+}
+
+static ionize_status stop( ionized_shard * const self )
+{
+    if(( NULL == self ) || ( NULL == self->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_shard_state * const state = self->state;
+    if( !state->running )
+    {
+        return ENOENT;
+    }
+    atomic_store( &( state->stopping ), true );
+    ionize_status const woken = state->loop.wake( &( state->loop ));
+    if( 0 != woken )
+    {
+        /* the worker still notices within a tick */
+        IONIZE_ERROR( "shard %"PRIu32" wake failed: %d", state->index, woken );
+    }
+    ionize_status const result = pthread_join( state->worker, NULL );
+    state->running = false;
+    return result;
+}
+
+ionized_shard_setup_result ionized_shard_setup(
+    uint32_t const index,
+    uint32_t const shards,
+    int const cpu,
+    uint32_t const sampling,
+    ionized_quota * const quota
+)
+{
+    ionized_shard_setup_result result =
+    {
+        .status = 0,
+        .shard =
+        {
+            .state = NULL,
+            .queue = queue,
+            .loop = loop,
+            .reaper = reaper,
+            .start = start,
+            .stop = stop
+        }
+    };
+    if( shards <= index )
+    {
+        result.status = EINVAL;
+        return result;
+    }
+
+    ionized_shard_state * const state = malloc( sizeof( ionized_shard_state ));
+    if( NULL == state )
+    {
+        result.status = ENOMEM;
+        return result;
+    }
+    memset( state, 0, sizeof( ionized_shard_state ));
+    state->index = index;
+    state->shards = shards;
+    state->cpu = cpu;
+    state->sampling = sampling;
+    state->quota = quota;
+    atomic_init( &( state->stopping ), false );
+
+    ionized_loop_setup_result const setup = ionized_loop_setup();
+    if( 0 != setup.status )
+    {
+        free( state );
+        result.status = setup.status;
+        return result;
+    }
+    state->loop = setup.loop;
+    ionized_reaper_setup_result const reaping =
+        ionized_reaper_setup( &( state->loop ));
+    if( 0 != reaping.status )
+    {
+        UNUSED( ionized_loop_cleanup( &( state->loop )));
+        free( state );
+        result.status = reaping.status;
+        return result;
+    }
+    state->reaper = reaping.reaper;
+
+    result.shard.state = state;
+    return result;
+}
+
+ionize_status ionized_shard_cleanup( ionized_shard * const shard )
+{
+    if(( NULL == shard ) || ( NULL == shard->state ))
+    {
+        return EINVAL;
+    }
+
+    ionized_shard_state * const state = shard->state;
+    ionize_status result = 0;
+    if( state->running )
+    {
+        result = shard->stop( shard );
+    }
+    /* locks of clients still tracked go with their queues */
+    ionize_status const reaped = ionized_reaper_cleanup( &( state->reaper ));
+    if( 0 != reaped )
+    {
+        result = reaped;
+    }
+    for( size_t i = 0U; i < state->count; ++i )
+    {
+        ionize_status const cleaned =
+            ionized_queue_cleanup( state->queues[ i ].queue );
+        if( 0 != cleaned )
+        {
+            result = cleaned;
+        }
+        free( state->queues[ i ].queue );
+    }
+    free( state->queues );
+    ionize_status const cleaned = ionized_loop_cleanup( &( state->loop ));
+    if( 0 != cleaned )
+    {
+        result = cleaned;
+    }
+    free( state );
+    shard->state = NULL;
+    return result;
+}
@@ -0,0 +1,178 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_elastic scaling of a queue.
+ * \date        10/20/2026 10:20:37 AM
+ * \file        test_elastic_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/elastic.h>
+#include <ionized/pressure.h>
+#include <ionized/queue.h>
+#include <plasma/properties.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BUFSIZE 4096U
+#define CLIENT 7U
+
+static plasma_properties const any = { 1U, BUFSIZE, 1U };
+
+/* pressure is simulated, the kernel can't be made to report it */
+static bool pressed = false;
+static uint64_t shed[ IONIZED_PRESSURE_TRIMMED + 1 ];
+
+static bool active( ionized_pressure const * const self )
+{
+    UNUSED( self );
+    return pressed;
+}
+
+static ionize_status record(
+    ionized_pressure * const self,
+    ionized_pressure_action const action,
+    uint64_t const count
+)
+{
+    UNUSED( self );
+    shed[ action ] += count;
+    return 0;
+}
+
+/* locks all free buffers for writing and commits them */
+static void exhaust( ionized_queue * const q )
+{
+    ionized_queue_lock w;
+    while( 0 == ( w = q->write_lock( q, CLIENT, any, false )).status )
+    {
+        assert( 0 == q->unlock( q, w.hold ));
+    }
+    assert( EAGAIN == w.status );
+}
+
+/* reads and releases all committed buffers */
+static void drain( ionized_queue * const q )
+{
+    ionized_queue_lock r;
+    while( 0 == ( r = q->read_lock( q, CLIENT, any, false )).status )
+    {
+        assert( 0 == q->unlock( q, r.hold ));
+    }
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_elastic elastic;
+    ionized_elastic_policy const none = { 0U, 0U, 0U, NULL, 0U };
+    assert( EINVAL == ionized_elastic_init( &elastic, none ));
+    ionized_elastic_policy const policy = { 5U * BUFSIZE, 2U, 1U, NULL, 2U };
+    assert( 0 == ionized_elastic_init( &elastic, policy ));
+
+    ionized_queue_setup_result setup = ionized_queue_setup( 1U, 0U, NULL );
+    assert( 0 == setup.status );
+    ionized_queue * const q = &( setup.queue );
+
+    /* nothing to do for queue without buffers */
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+
+    plasma_properties const properties[] = { { BUFSIZE, BUFSIZE, 1U } };
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+
+    /* single burst of starved writers is left alone */
+    exhaust( q );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 1U == q->stats( q, false ).buffers );
+
+    /* writers starved step after step grow the queue, up to the budget */
+    for( size_t i = 0U; i < 4U; ++i )
+    {
+        exhaust( q );
+        assert( 0 == ionized_elastic_step( &elastic, q ).change );
+        exhaust( q );
+        assert( 1 == ionized_elastic_step( &elastic, q ).change );
+    }
+    exhaust( q );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    exhaust( q );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 5U == q->stats( q, false ).buffers );
+
+    /* idle surplus is retired, down to the minimum */
+    drain( q );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( -3 == ionized_elastic_step( &elastic, q ).change );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 2U == q->stats( q, true ).buffers );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    ionized_queue_stats const stats = q->stats( q, true );
+    assert( 2U == stats.buffers );
+    assert( 2U * BUFSIZE == stats.bytes );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* surplus freed recently isn't retired */
+    ionized_elastic_policy const patient =
+        { 5U * BUFSIZE, 1U, 60000000000U, NULL, 1U };
+    assert( 0 == ionized_elastic_init( &elastic, patient ));
+    setup = ionized_queue_setup( 3U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 3U == q->stats( q, false ).buffers );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* under pressure growth is refused, free buffers go at once */
+    ionized_pressure monitor = { NULL, active, record, NULL };
+    ionized_elastic_policy const shedding =
+        { 5U * BUFSIZE, 1U, UINT64_MAX, &monitor, 1U };
+    assert( 0 == ionized_elastic_init( &elastic, shedding ));
+    setup = ionized_queue_setup( 2U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    exhaust( q );
+    pressed = true;
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    assert( 1U == shed[ IONIZED_PRESSURE_REJECTED ] );
+    pressed = false;
+    exhaust( q );
+    assert( 1 == ionized_elastic_step( &elastic, q ).change );
+    exhaust( q );
+    assert( 1 == ionized_elastic_step( &elastic, q ).change );
+    drain( q );
+    assert( 0 == ionized_elastic_step( &elastic, q ).change );
+    /* buffers pinned by snapshots stay, they aren't counted as shed */
+    ionized_queue_lock const first = q->snapshot_lock( q, CLIENT, any );
+    assert( 0 == first.status );
+    ionized_queue_lock const w = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, w.hold ));
+    drain( q );
+    ionized_queue_lock const second = q->snapshot_lock( q, CLIENT, any );
+    assert(( 0 == second.status ) && ( first.data != second.data ));
+    pressed = true;
+    assert( -1 == ionized_elastic_step( &elastic, q ).change );
+    assert( 1U == shed[ IONIZED_PRESSURE_SHRUNK ] );
+    assert( 2U == q->stats( q, false ).buffers );
+    assert( 0 == q->unlock( q, first.hold ));
+    assert( 0 == q->unlock( q, second.hold ));
+    assert( -1 == ionized_elastic_step( &elastic, q ).change );
+    assert( 2U == shed[ IONIZED_PRESSURE_SHRUNK ] );
+    assert( 2U == shed[ IONIZED_PRESSURE_TRIMMED ] );
+    assert( 1U == q->stats( q, false ).buffers );
+    assert( 1U == q->stats( q, false ).reclaimed );
+    assert( 0 == ionized_queue_cleanup( q ));
+    return 0;
+}
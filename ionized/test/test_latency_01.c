@@ -0,0 +1,77 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_latency histograms.
+ * \date        10/19/2026 11:58:40 AM
+ * \file        test_latency_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/latency.h>
+#include <stddef.h>
+#include <stdint.h>
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_latency latency;
+    assert( EINVAL == ionized_latency_init( NULL, 0U ));
+    assert( ERANGE == ionized_latency_init( &latency, 64U ));
+
+    /* every buffer sampled */
+    assert( 0 == ionized_latency_init( &latency, 0U ));
+    for( unsigned int i = 0; i < 8U; ++i )
+    {
+        assert( ionized_latency_sample( &latency ));
+    }
+
+    /* one in four buffers sampled */
+    assert( 0 == ionized_latency_init( &latency, 2U ));
+    unsigned int sampled = 0U;
+    for( unsigned int i = 0; i < 16U; ++i )
+    {
+        sampled += ionized_latency_sample( &latency ) ? 1U : 0U;
+    }
+    assert( 4U == sampled );
+
+    /* unstamped or reversed durations are ignored */
+    ionized_latency_record( &latency, IONIZED_LATENCY_QUEUEING, 0U, 10U );
+    ionized_latency_record( &latency, IONIZED_LATENCY_QUEUEING, 10U, 5U );
+    ionized_latency_snapshot_result snapshot =
+        ionized_latency_snapshot( &latency );
+    assert( 16U == snapshot.cycles );
+    assert( 0U == ionized_latency_quantile(
+                &snapshot, IONIZED_LATENCY_QUEUEING, 500U ));
+
+    /* 1ns, 2ns, 3ns and 1000ns */
+    ionized_latency_record( &latency, IONIZED_LATENCY_QUEUEING, 1U, 2U );
+    ionized_latency_record( &latency, IONIZED_LATENCY_QUEUEING, 1U, 3U );
+    ionized_latency_record( &latency, IONIZED_LATENCY_QUEUEING, 1U, 4U );
+    ionized_latency_record( &latency, IONIZED_LATENCY_QUEUEING, 1U, 1001U );
+    ionized_latency_record( &latency, IONIZED_LATENCY_READ_HOLD, 7U, 7U );
+    snapshot = ionized_latency_snapshot( &latency );
+    assert( 1U == snapshot.buckets[ IONIZED_LATENCY_QUEUEING ][ 0 ] );
+    assert( 2U == snapshot.buckets[ IONIZED_LATENCY_QUEUEING ][ 1 ] );
+    assert( 1U == snapshot.buckets[ IONIZED_LATENCY_QUEUEING ][ 9 ] );
+    assert( 1U == snapshot.buckets[ IONIZED_LATENCY_READ_HOLD ][ 0 ] );
+    assert( 0U == snapshot.buckets[ IONIZED_LATENCY_WRITE_HOLD ][ 0 ] );
+
+    assert( 1U == ionized_latency_quantile(
+                &snapshot, IONIZED_LATENCY_QUEUEING, 0U ));
+    assert( 3U == ionized_latency_quantile(
+                &snapshot, IONIZED_LATENCY_QUEUEING, 500U ));
+    assert( 1023U == ionized_latency_quantile(
+                &snapshot, IONIZED_LATENCY_QUEUEING, 990U ));
+    assert( 1023U == ionized_latency_quantile(
+                &snapshot, IONIZED_LATENCY_QUEUEING, 2000U ));
+    assert( 0U == ionized_latency_quantile(
+                &snapshot, IONIZED_LATENCY_KINDS, 500U ));
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_loop.
+ * \date        10/21/2026 01:27:50 PM
+ * \file        test_loop_01.c
+ * \version     1.0
+ *
+ * Clients are filaments over non-blocking sequenced packet sockets.
+ **/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <filament/filament.h>
+#include <ionize/universal.h>
+#include <ionized/loop.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define CLIENTS 200U
+
+struct filament_state_struct
+{
+    int fd; /* daemon side */
+    int peer; /* client side */
+};
+
+static filament_rx try_rx( filament const * const self )
+{
+    filament_rx result = { 0, { NULL, 0U } };
+    uint8_t byte;
+    ssize_t const received = recv( self->state->fd, &byte, 1U, MSG_DONTWAIT );
+    if( 0 > received )
+    {
+        result.status = errno;
+        return result;
+    }
+    if( 0 == received )
+    {
+        result.status = ECONNRESET;
+        return result;
+    }
+    result.buf.data = malloc( 1U );
+    assert( NULL != result.buf.data );
+    result.buf.data[ 0 ] = byte;
+    result.buf.size = 1U;
+    return result;
+}
+
+static int fd( filament const * const self )
+{
+    return self->state->fd;
+}
+
+static filament_state states[ CLIENTS ];
+static filament clients[ CLIENTS ];
+static size_t received[ CLIENTS ];
+static size_t failed;
+
+static ionize_status handler(
+    void * const context,
+    filament const * const client,
+    filament_rx const rx
+)
+{
+    size_t const index = ( size_t ) ( client - clients );
+    assert( &( states[ index ] ) == context );
+    if( 0 != rx.status )
+    {
+        ++failed;
+        return 0;
+    }
+    ++( received[ index ] );
+    uint8_t const byte = rx.buf.data[ 0 ];
+    free( rx.buf.data );
+    /* 'q' asks to be disconnected */
+    return ( 'q' == byte ) ? ECANCELED : 0;
+}
+
+static void send_byte( size_t const index, uint8_t const byte )
+{
+    assert( 1 == send( states[ index ].peer, &byte, 1U, 0 ));
+}
+
+static void * waker( void * ptr )
+{
+    ionized_loop * const loop = ptr;
+    assert( 0 == loop->wake( loop ));
+    return NULL;
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_loop_setup_result setup = ionized_loop_setup();
+    assert( 0 == setup.status );
+    ionized_loop * const loop = &( setup.loop );
+
+    filament unpollable = { &( states[ 0 ] ), NULL, NULL, NULL, NULL };
+    assert( ENOTSUP == loop->watch( loop, &unpollable, handler, NULL ));
+    for( size_t i = 0U; i < CLIENTS; ++i )
+    {
+        int pair[ 2 ];
+        assert( 0 == socketpair( AF_UNIX, SOCK_SEQPACKET, 0, pair ));
+        states[ i ] = ( filament_state ) { pair[ 0 ], pair[ 1 ] };
+        clients[ i ] =
+            ( filament ) { &( states[ i ] ), NULL, NULL, fd, try_rx };
+        assert( 0 == loop->watch(
+                    loop,
+                    &( clients[ i ] ),
+                    handler,
+                    &( states[ i ] )
+        ));
+    }
+    assert( EEXIST == loop->watch( loop, &( clients[ 0 ] ), handler, NULL ));
+    assert( CLIENTS == loop->watched( loop ));
+
+    /* idle clients don't wake the loop */
+    ionized_loop_run_result result = loop->run( loop, 0 );
+    assert(( 0 == result.status ) && ( 0U == result.handled ));
+
+    /* sent before the loop looked, a few clients at once */
+    send_byte( 3U, 'a' );
+    send_byte( 3U, 'b' );
+    send_byte( 150U, 'a' );
+    result = loop->run( loop, -1 );
+    assert(( 0 == result.status ) && ( 3U == result.handled ));
+    assert(( 2U == received[ 3 ] ) && ( 1U == received[ 150 ] ));
+
+    /* chatty client is served in batches, without further readiness */
+    for( size_t i = 0U; i < IONIZED_LOOP_BATCH + 10U; ++i )
+    {
+        send_byte( 7U, 'x' );
+    }
+    send_byte( 8U, 'x' );
+    result = loop->run( loop, -1 );
+    assert( IONIZED_LOOP_BATCH + 1U == result.handled );
+    result = loop->run( loop, -1 );
+    assert( 10U == result.handled );
+    assert( IONIZED_LOOP_BATCH + 10U == received[ 7 ] );
+
+    /* handlers disconnect clients, so do the clients going away */
+    send_byte( 11U, 'q' );
+    send_byte( 11U, 'a' );
+    assert( 0 == close( states[ 12 ].peer ));
+    result = loop->run( loop, -1 );
+    assert( 2U == result.handled );
+    assert(( 1U == received[ 11 ] ) && ( 1U == failed ));
+    assert( CLIENTS - 2U == loop->watched( loop ));
+    assert( ENOENT == loop->unwatch( loop, &( clients[ 11 ] )));
+    assert( 0 == loop->unwatch( loop, &( clients[ 13 ] )));
+    send_byte( 13U, 'a' );
+    assert( 0U == loop->run( loop, 0 ).handled );
+
+    /* waiting run is interrupted from another thread */
+    pthread_t thread;
+    assert( 0 == pthread_create( &thread, NULL, waker, loop ));
+    result = loop->run( loop, -1 );
+    assert(( 0 == result.status ) && ( 0U == result.handled ));
+    assert( 0 == pthread_join( thread, NULL ));
+
+    assert( 0 == ionized_loop_cleanup( loop ));
+    assert( EINVAL == ionized_loop_cleanup( loop ));
+    for( size_t i = 0U; i < CLIENTS; ++i )
+    {
+        UNUSED( close( states[ i ].fd ));
+        UNUSED( close( states[ i ].peer ));
+    }
+    return 0;
+}
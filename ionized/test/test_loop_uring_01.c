@@ -0,0 +1,177 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_loop over the io_uring backend.
+ * \date        10/22/2026 05:31:07 PM
+ * \file        test_loop_uring_01.c
+ * \version     1.0
+ *
+ * Aimed at ionized/src/loop/uring.c, linked with liburing in place of
+ * epoll.c, though the loop over epoll passes it too. Watches more clients
+ * than a fixed file table would hold and reuses descriptors before the loop
+ * waits again, as clients churning do. Kernels without io_uring, or with it
+ * disabled, fail the setup; the test passes then.
+ **/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <filament/filament.h>
+#include <ionize/universal.h>
+#include <ionized/loop.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define CLIENTS 5000U
+#define CHURNS 100U
+
+struct filament_state_struct
+{
+    int fd; /* daemon side */
+    int peer; /* client side */
+};
+
+static filament_rx try_rx( filament const * const self )
+{
+    filament_rx result = { 0, { NULL, 0U } };
+    uint8_t byte;
+    ssize_t const received = recv( self->state->fd, &byte, 1U, MSG_DONTWAIT );
+    if( 0 > received )
+    {
+        result.status = errno;
+        return result;
+    }
+    if( 0 == received )
+    {
+        result.status = ECONNRESET;
+        return result;
+    }
+    result.buf.data = malloc( 1U );
+    assert( NULL != result.buf.data );
+    result.buf.data[ 0 ] = byte;
+    result.buf.size = 1U;
+    return result;
+}
+
+static int fd( filament const * const self )
+{
+    return self->state->fd;
+}
+
+static filament_state states[ CLIENTS ];
+static filament clients[ CLIENTS ];
+static size_t received[ CLIENTS ];
+
+static ionize_status handler(
+    void * const context,
+    filament const * const client,
+    filament_rx const rx
+)
+{
+    size_t const index = ( size_t ) ( client - clients );
+    assert( &( states[ index ] ) == context );
+    assert( 0 == rx.status );
+    ++( received[ index ] );
+    free( rx.buf.data );
+    return 0;
+}
+
+static void connect_client( ionized_loop * const loop, size_t const index )
+{
+    int pair[ 2 ];
+    assert( 0 == socketpair( AF_UNIX, SOCK_SEQPACKET, 0, pair ));
+    states[ index ] = ( filament_state ) { pair[ 0 ], pair[ 1 ] };
+    clients[ index ] =
+        ( filament ) { &( states[ index ] ), NULL, NULL, fd, try_rx };
+    received[ index ] = 0U;
+    assert( 0 == loop->watch(
+                loop,
+                &( clients[ index ] ),
+                handler,
+                &( states[ index ] )
+    ));
+}
+
+static void send_byte( size_t const index, uint8_t const byte )
+{
+    assert( 1 == send( states[ index ].peer, &byte, 1U, 0 ));
+}
+
+static void * waker( void * ptr )
+{
+    ionized_loop * const loop = ptr;
+    assert( 0 == loop->wake( loop ));
+    return NULL;
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    /* the file table is sized from the limit when the loop is created */
+    struct rlimit limit;
+    assert( 0 == getrlimit( RLIMIT_NOFILE, &limit ));
+    limit.rlim_cur = limit.rlim_max;
+    assert( 0 == setrlimit( RLIMIT_NOFILE, &limit ));
+    size_t const count = ( 2U * CLIENTS + 64U < limit.rlim_cur )
+        ? CLIENTS
+        : ( size_t ) ( limit.rlim_cur - 64U ) / 2U;
+
+    ionized_loop_setup_result setup = ionized_loop_setup();
+    if( 0 != setup.status )
+    {
+        return 0;
+    }
+    ionized_loop * const loop = &( setup.loop );
+    for( size_t i = 0U; i < count; ++i )
+    {
+        connect_client( loop, i );
+    }
+    assert( count == loop->watched( loop ));
+    ionized_loop_run_result result = loop->run( loop, 0 );
+    assert(( 0 == result.status ) && ( 0U == result.handled ));
+
+    /* descriptors at the top of the table work like the first ones */
+    send_byte( 0U, 'a' );
+    send_byte( count - 1U, 'a' );
+    result = loop->run( loop, -1 );
+    assert(( 0 == result.status ) && ( 2U == result.handled ));
+    assert(( 1U == received[ 0 ] ) && ( 1U == received[ count - 1U ] ));
+
+    /* ready client replaced before the wait, its number goes to the next */
+    for( size_t i = 0U; i < CHURNS; ++i )
+    {
+        size_t const index = ( i * 37U ) % count;
+        send_byte( index, 'a' );
+        assert( 0 == loop->unwatch( loop, &( clients[ index ] )));
+        assert( 0 == close( states[ index ].fd ));
+        assert( 0 == close( states[ index ].peer ));
+        connect_client( loop, index );
+        send_byte( index, 'b' );
+        result = loop->run( loop, -1 );
+        assert(( 0 == result.status ) && ( 1U == result.handled ));
+        assert( 1U == received[ index ] );
+    }
+    assert( count == loop->watched( loop ));
+
+    /* waiting run is interrupted from another thread */
+    pthread_t thread;
+    assert( 0 == pthread_create( &thread, NULL, waker, loop ));
+    result = loop->run( loop, -1 );
+    assert(( 0 == result.status ) && ( 0U == result.handled ));
+    assert( 0 == pthread_join( thread, NULL ));
+
+    assert( 0 == ionized_loop_cleanup( loop ));
+    for( size_t i = 0U; i < count; ++i )
+    {
+        UNUSED( close( states[ i ].fd ));
+        UNUSED( close( states[ i ].peer ));
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_manifest.
+ * \date        10/23/2026 04:21:37 PM
+ * \file        test_manifest_01.c
+ * \version     1.0
+ *
+ * Uses pthreads and a temporary file.
+ **/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/buffer.h>
+#include <ionized/manifest.h>
+#include <ionized/pool.h>
+#include <ionized/queue.h>
+#include <ionized/shard.h>
+#include <plasma/config.h>
+#include <plasma/header.h>
+#include <plasma/properties.h>
+#include <plasma/shard.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SHARDS 2U
+#define BUFSIZE 4096U
+#define CLIENT 7U
+
+static char const text[] =
+    "# name   uid  count  minimum  maximum  alignment  options\n"
+    "\n"
+    "telemetry 17  16     4096     4096     16  header prefault\n"
+    "   control 0x12 2 512 1024 8 # latest would go here\n"
+    "bulk 19 40 65536 65536 1 overwrite\n";
+
+static plasma_properties const any = { 1U, SIZE_MAX, 1U };
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    /* errors point at the faulty line */
+    assert( EINVAL == ionized_manifest_parse( NULL ).status );
+    ionized_manifest_parse_result bad =
+        ionized_manifest_parse( "a 1 1 8 8 1\nb 2 1 8 8\n" );
+    assert(( EINVAL == bad.status ) && ( 2U == bad.line ));
+    assert( NULL == bad.manifest.entries );
+    bad = ionized_manifest_parse( "a 1 1 8 8 1\n\n# c\nb 1 1 8 8 1\n" );
+    assert(( EEXIST == bad.status ) && ( 4U == bad.line ));
+    bad = ionized_manifest_parse( "a 1 1 8 8 1 hugepages\n" );
+    assert( ENOTSUP == bad.status );
+    bad = ionized_manifest_parse( "a 1 0 8 8 1\n" );
+    assert( EINVAL == bad.status );
+    bad = ionized_manifest_parse( "a -1 1 8 8 1\n" );
+    assert( EINVAL == bad.status );
+    bad = ionized_manifest_parse( "a 4294967296 1 8 8 1\n" );
+    assert( EINVAL == bad.status );
+    bad = ionized_manifest_parse( "a 1 65537 8 8 1\n" );
+    assert( EINVAL == bad.status );
+    bad = ionized_manifest_parse( "a 1 18446744073709551615 8 8 1\n" );
+    assert( EINVAL == bad.status );
+    bad = ionized_manifest_parse( "a 1 1 16 8 1\n" );
+    assert( ERANGE == bad.status );
+    char name[ IONIZED_MANIFEST_NAME + 16U ];
+    memset( name, 'n', IONIZED_MANIFEST_NAME );
+    strcpy( name + IONIZED_MANIFEST_NAME, " 1 1 8 8 1" );
+    assert( ENAMETOOLONG == ionized_manifest_parse( name ).status );
+
+    ionized_manifest_parse_result parsed = ionized_manifest_parse( "" );
+    assert(( 0 == parsed.status ) && ( 0U == parsed.manifest.count ));
+    assert( 0 == ionized_manifest_cleanup( &( parsed.manifest )));
+
+    /* file is read whole */
+    char path[] = "/tmp/test_manifest_XXXXXX";
+    int const fd = mkstemp( path );
+    assert( -1 != fd );
+    assert( sizeof( text ) - 1U
+            == ( size_t ) write( fd, text, sizeof( text ) - 1U ));
+    assert( 0 == close( fd ));
+    parsed = ionized_manifest_load( path );
+    assert( 0 == unlink( path ));
+    assert( ENOENT == ionized_manifest_load( path ).status );
+    assert( 0 == parsed.status );
+    ionized_manifest * const manifest = &( parsed.manifest );
+    assert( 3U == manifest->count );
+    ionized_manifest_entry const * const e = manifest->entries;
+    assert( 0 == strcmp( "telemetry", e[ 0 ].name ));
+    assert(( 17U == e[ 0 ].uid ) && ( 16U == e[ 0 ].count ));
+    assert( 16U == e[ 0 ].properties.alignment );
+    assert( PLASMA_CONFIG_HEADER == e[ 0 ].config.flags );
+    assert( IONIZED_BUFFER_PREFAULT == e[ 0 ].backing );
+    assert( 0 == strcmp( "control", e[ 1 ].name ));
+    assert(( 18U == e[ 1 ].uid ) && ( 0U == e[ 1 ].config.flags ));
+    assert(( 512U == e[ 1 ].properties.minimum ));
+    assert(( 1024U == e[ 1 ].properties.maximum ));
+    assert( PLASMA_CONFIG_OVERWRITE == e[ 2 ].config.flags );
+
+    /* queues are created by their shards, buffers by the pool */
+    ionized_shard_setup_result setup[ SHARDS ];
+    ionized_shard * shards[ SHARDS ];
+    for( uint32_t i = 0U; i < SHARDS; ++i )
+    {
+        setup[ i ] = ionized_shard_setup( i, SHARDS, -1, 0U, NULL );
+        assert( 0 == setup[ i ].status );
+        shards[ i ] = &( setup[ i ].shard );
+    }
+    ionized_pool_setup_result pool = ionized_pool_setup( 4U, 1U );
+    assert( 0 == pool.status );
+    assert( EINVAL == ionized_manifest_warm( NULL, shards, SHARDS, NULL, 0U ));
+    /* counts of all queues must fit the tasks in memory */
+    ionized_manifest_entry huge[ 2 ] = { e[ 0 ], e[ 1 ] };
+    huge[ 0 ].count = SIZE_MAX / 2U + 1U;
+    huge[ 1 ].count = SIZE_MAX / 2U + 1U;
+    ionized_manifest const overflowing = { huge, 2U };
+    assert( EINVAL == ionized_manifest_warm(
+                &overflowing,
+                shards,
+                SHARDS,
+                NULL,
+                0U
+    ));
+    huge[ 0 ].count = SIZE_MAX;
+    ionized_manifest const wrapping = { huge, 1U };
+    assert( EINVAL == ionized_manifest_warm(
+                &wrapping,
+                shards,
+                SHARDS,
+                NULL,
+                0U
+    ));
+    assert( 0 == ionized_manifest_warm(
+                manifest,
+                shards,
+                SHARDS,
+                &( pool.pool ),
+                0U
+    ));
+    for( size_t i = 0U; i < manifest->count; ++i )
+    {
+        uint32_t const index = plasma_shard( e[ i ].uid, SHARDS );
+        ionized_shard * const owner = shards[ index ];
+        ionized_queue * const q = owner->queue( owner, e[ i ].uid ).queue;
+        assert( e[ i ].count == q->stats( q, false ).buffers );
+        ionized_queue_lock const w = q->write_lock( q, CLIENT, any, false );
+        assert( 0 == w.status );
+        assert( e[ i ].properties.maximum == w.size );
+        size_t const header =
+            ( 0U != ( e[ i ].config.flags & PLASMA_CONFIG_HEADER ))
+                ? sizeof( plasma_header )
+                : 0U;
+        assert( header == w.offset );
+        assert( 0 == q->unlock( q, w.hold ));
+    }
+    /* configured queues can't take the manifest again */
+    assert( EBUSY == ionized_manifest_warm(
+                manifest,
+                shards,
+                SHARDS,
+                NULL,
+                0U
+    ));
+
+    assert( 0 == ionized_pool_cleanup( &( pool.pool )));
+    for( uint32_t i = 0U; i < SHARDS; ++i )
+    {
+        assert( 0 == ionized_shard_cleanup( shards[ i ] ));
+    }
+    assert( 0 == ionized_manifest_cleanup( manifest ));
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_pool.
+ * \date        10/22/2026 11:31:27 AM
+ * \file        test_pool_01.c
+ * \version     1.0
+ *
+ * Uses pthreads.
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/pool.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TASKS 1000U
+#define CHILDREN 10U
+
+static atomic_size_t done;
+static atomic_bool started;
+static atomic_bool released;
+static ionized_pool * pool;
+static ionized_task tasks[ TASKS ];
+static ionized_task children[ CHILDREN ];
+
+static void count( ionized_task * const task )
+{
+    UNUSED( task );
+    UNUSED( atomic_fetch_add( &done, 1U ));
+}
+
+static void parent( ionized_task * const task )
+{
+    UNUSED( task );
+    for( size_t i = 0U; i < CHILDREN; ++i )
+    {
+        children[ i ] = ( ionized_task ) { count, NULL };
+        /* producer is ignored inside tasks */
+        assert( 0 == pool->submit( pool, 99U, &( children[ i ] )));
+    }
+    UNUSED( atomic_fetch_add( &done, 1U ));
+}
+
+static void gate( ionized_task * const task )
+{
+    UNUSED( task );
+    atomic_store( &started, true );
+    while( !atomic_load( &released ))
+    {
+    }
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( EINVAL == ionized_pool_setup( 0U, 1U ).status );
+    ionized_pool_setup_result setup = ionized_pool_setup( 4U, 2U );
+    assert( 0 == setup.status );
+    pool = &( setup.pool );
+    atomic_init( &done, 0U );
+
+    ionized_task invalid = { NULL, NULL };
+    assert( EINVAL == pool->submit( pool, 0U, &invalid ));
+    ionized_task spawning = { parent, NULL };
+    assert( ERANGE == pool->submit( pool, 2U, &spawning ));
+
+    /* burst on one producer is run by all workers */
+    for( size_t i = 0U; i < TASKS; ++i )
+    {
+        tasks[ i ] = ( ionized_task ) { count, NULL };
+        assert( 0 == pool->submit( pool, 0U, &( tasks[ i ] )));
+    }
+    assert( 0 == pool->submit( pool, 1U, &spawning ));
+    assert( 0 == ionized_pool_cleanup( pool ));
+    assert( TASKS + 1U + CHILDREN == atomic_load( &done ));
+    assert( 0U == pool->stats( pool ).executed );
+    assert( EINVAL == ionized_pool_cleanup( pool ));
+
+    /* full deque is reported while the only worker is busy */
+    setup = ionized_pool_setup( 1U, 1U );
+    assert( 0 == setup.status );
+    atomic_init( &started, false );
+    atomic_init( &released, false );
+    atomic_store( &done, 0U );
+    ionized_task blocking = { gate, NULL };
+    assert( 0 == pool->submit( pool, 0U, &blocking ));
+    while( !atomic_load( &started ))
+    {
+    }
+    for( size_t i = 0U; i < IONIZED_POOL_DEPTH; ++i )
+    {
+        assert( 0 == pool->submit( pool, 0U, &( tasks[ i % TASKS ] )));
+    }
+    assert( EAGAIN == pool->submit( pool, 0U, &( tasks[ 0 ] )));
+    atomic_store( &released, true );
+    assert( 0 == ionized_pool_cleanup( pool ));
+    assert( IONIZED_POOL_DEPTH == atomic_load( &done ));
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_pressure.
+ * \date        10/24/2026 05:12:19 PM
+ * \file        test_pressure_01.c
+ * \version     1.0
+ *
+ * Kernels without pressure stall information, or refusing the trigger in
+ * a container, fail the setup; the monitor is then tested up to that point.
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/pressure.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* setup which is expected to fail */
+static ionize_status refused(
+    char const * const path,
+    uint32_t const stall,
+    uint32_t const window
+)
+{
+    ionized_pressure_policy const policy = { path, stall, window };
+    ionized_pressure_setup_result const setup =
+        ionized_pressure_setup( policy );
+    assert( NULL == setup.pressure.state );
+    return setup.status;
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( EINVAL == ionized_pressure_cleanup( NULL ));
+    assert( EINVAL == refused( NULL, 0U, 100000U ));
+    assert( EINVAL == refused( NULL, 0U, 20000000U ));
+    assert( EINVAL == refused( NULL, 600000U, 500000U ));
+    assert( ENOENT == refused( "/nonexistent", 0U, 0U ));
+
+    ionized_pressure_setup_result setup =
+        ionized_pressure_setup(( ionized_pressure_policy ) { NULL, 0U, 0U });
+    if( 0 != setup.status )
+    {
+        return 0;
+    }
+    ionized_pressure * const p = &( setup.pressure );
+    ionized_pressure_stats stats = p->stats( p );
+    assert( 0U == stats.events );
+    assert( !stats.active );
+    assert( !p->active( p ));
+    assert( EINVAL == p->shed( NULL, IONIZED_PRESSURE_SHRUNK, 1U ));
+    ionized_pressure_action const unknown =
+        ( ionized_pressure_action ) ( IONIZED_PRESSURE_TRIMMED + 1 );
+    assert( EINVAL == p->shed( p, unknown, 1U ));
+    assert( 0 == p->shed( p, IONIZED_PRESSURE_REJECTED, 3U ));
+    assert( 0 == p->shed( p, IONIZED_PRESSURE_SHRUNK, 2U ));
+    assert( 0 == p->shed( p, IONIZED_PRESSURE_TRIMMED, 1U ));
+    stats = p->stats( p );
+    assert( 3U == stats.rejected );
+    assert( 2U == stats.shrunk );
+    assert( 1U == stats.trimmed );
+    assert( 0 == ionized_pressure_cleanup( p ));
+    assert( EINVAL == ionized_pressure_cleanup( p ));
+    return 0;
+}
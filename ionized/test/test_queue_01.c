@@ -0,0 +1,661 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_queue.
+ * \date        10/19/2026 04:12:55 PM
+ * \file        test_queue_01.c
+ * \version     1.0
+ *
+ * Uses pthreads.
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/buffer.h>
+#include <ionized/latency.h>
+#include <ionized/pool.h>
+#include <ionized/queue.h>
+#include <ionized/quota.h>
+#include <plasma/config.h>
+#include <plasma/header.h>
+#include <plasma/properties.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define BUFSIZE 4096U
+#define CLIENT 7U
+#define LARGE ( 8U << 20 )
+
+static plasma_properties const any = { 1U, BUFSIZE, 1U };
+
+static void * writer( void * ptr )
+{
+    ionized_queue * const q = ptr;
+    ionized_queue_lock const w = q->write_lock( q, CLIENT, any, true );
+    assert( 0 == w.status );
+    assert( 0 == q->unlock( q, w.hold ));
+    return NULL;
+}
+
+/* charging happens while allocate has the mutex released */
+static ionized_queue * racing = NULL;
+
+static ionize_status reconfigure(
+    ionized_quota * const self,
+    uint32_t const uid,
+    uint32_t const client,
+    size_t const bytes
+)
+{
+    UNUSED( self );
+    UNUSED( uid );
+    UNUSED( client );
+    UNUSED( bytes );
+    if( NULL != racing )
+    {
+        plasma_config const header = { PLASMA_CONFIG_HEADER };
+        assert( 0 == racing->configure( racing, header ));
+        racing = NULL;
+    }
+    return 0;
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_queue_setup_result setup = ionized_queue_setup( 1U, 0U, NULL );
+    assert( 0 == setup.status );
+    ionized_queue * const q = &( setup.queue );
+
+    plasma_properties const properties[] =
+    {
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U }
+    };
+    assert( 0 == q->configure( q, ( plasma_config ) { PLASMA_CONFIG_HEADER } ));
+    assert( ENOENT == q->write_lock( q, CLIENT, any, true ).status );
+    assert( 0 == q->allocate( q, CLIENT, properties, 2U, 0U ));
+    assert( EBUSY == q->configure( q, ( plasma_config ) { 0U } ));
+
+    /* committed length and header are visible to reader */
+    ionized_queue_lock const w = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == w.status );
+    assert( BUFSIZE == w.size );
+    assert( sizeof( plasma_header ) == w.offset );
+    assert( ERANGE == q->commit( q, w.hold, BUFSIZE + 1U ));
+    memcpy( w.data, "ionize", 6U );
+    assert( 0 == q->commit( q, w.hold, 6U ));
+    assert( EPERM == q->commit( q, w.hold, 6U ));
+
+    ionized_queue_lock r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    assert( 6U == r.size );
+    assert( 0 == memcmp( r.data, "ionize", 6U ));
+    plasma_header const * const header = plasma_header_of( r.data );
+    assert( 1U == header->sequence );
+    assert( 6U == header->length );
+    assert( CLIENT == header->producer );
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( EPERM == q->unlock( q, r.hold ));
+
+    /* readers get buffers in commit order */
+    ionized_queue_lock const a = q->write_lock( q, CLIENT, any, false );
+    ionized_queue_lock const b = q->write_lock( q, CLIENT, any, false );
+    assert(( 0 == a.status ) && ( 0 == b.status ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->unlock( q, b.hold ));
+    assert( 0 == q->unlock( q, a.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( b.hold == r.hold );
+    assert( BUFSIZE == r.size );
+
+    /* blocking writer waits for reader */
+    ionized_queue_lock const other = q->read_lock( q, CLIENT, any, false );
+    assert( a.hold == other.hold );
+    pthread_t thread;
+    assert( 0 == pthread_create( &thread, NULL, writer, q ));
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == pthread_join( thread, NULL ));
+    assert( 0 == q->unlock( q, other.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( b.hold == r.hold );
+    assert( 0 == q->unlock( q, r.hold ));
+
+    /* one buffer retired at once, the other when consumed */
+    assert( ERANGE == q->shrink( q, 3U ));
+    ionized_queue_lock const kept = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == kept.status );
+    assert( 0 == q->shrink( q, 2U ));
+    assert( ERANGE == q->shrink( q, 1U ));
+    assert( 0 == q->unlock( q, kept.hold ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( ENOENT == q->read_lock( q, CLIENT, any, false ).status );
+
+    /* retired entries are reused */
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0 == ( r = q->write_lock( q, CLIENT, any, false )).status );
+    assert( 0 == q->unlock( q, r.hold ));
+
+    ionized_latency_snapshot_result const latency = q->latency( q );
+    assert( 4U < latency.cycles );
+    uint64_t holds = 0U;
+    for( unsigned int i = 0; i < IONIZED_LATENCY_BUCKETS; ++i )
+    {
+        holds += latency.buckets[ IONIZED_LATENCY_WRITE_HOLD ][ i ];
+    }
+    assert( latency.cycles == holds );
+
+    assert( 0 == ionized_queue_cleanup( q ));
+    assert( EINVAL == ionized_queue_cleanup( q ));
+
+    /* overwriting queue drops oldest unread buffer instead of blocking */
+    setup = ionized_queue_setup( 2U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure(
+                q,
+                ( plasma_config ) { PLASMA_CONFIG_OVERWRITE } ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 2U, 0U ));
+    assert( 0 == q->backpressure( q, BUFSIZE ));
+    ionized_queue_lock const first = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->commit( q, first.hold, 1U ));
+    ionized_queue_lock const second = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->commit( q, second.hold, 2U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( first.hold == r.hold );
+    ionized_queue_lock const third = q->write_lock( q, CLIENT, any, false );
+    assert( second.hold == third.hold );
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->commit( q, third.hold, 3U ));
+    assert( 0 == q->unlock( q, r.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 3U == r.size );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 1U == q->stats( q, false ).drops );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* triple buffer: readers share latest buffer, writer always has one */
+    setup = ionized_queue_setup( 3U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure( q, ( plasma_config ) { PLASMA_CONFIG_LATEST } ));
+    plasma_properties const three[] =
+    {
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U }
+    };
+    assert( 0 == q->allocate( q, CLIENT, three, 3U, 0U ));
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    ionized_queue_lock frame = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->commit( q, frame.hold, 1U ));
+    ionized_queue_lock const stale = q->read_lock( q, CLIENT, any, false );
+    assert( frame.hold == stale.hold );
+    for( size_t i = 2U; i < 6U; ++i )
+    {
+        frame = q->write_lock( q, CLIENT, any, false );
+        assert( 0 == frame.status );
+        assert( 0 == q->commit( q, frame.hold, i ));
+    }
+    r = q->read_lock( q, CLIENT, any, false );
+    ionized_queue_lock const shared = q->read_lock( q, CLIENT, any, false );
+    assert(( frame.hold == r.hold ) && ( frame.hold == shared.hold ));
+    assert( 5U == r.size );
+    assert( 0 == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == q->unlock( q, shared.hold ));
+    assert( 0 == q->unlock( q, stale.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( frame.hold == r.hold );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* consumed buffers stay replayable until writers need them */
+    setup = ionized_queue_setup( 4U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->allocate( q, CLIENT, three, 3U, 0U ));
+    assert( 0 == q->retention( q, ( ionized_queue_retention ) { 2U, 0U } ));
+    for( size_t i = 1U; i < 4U; ++i )
+    {
+        frame = q->write_lock( q, CLIENT, any, false );
+        assert( 0 == q->commit( q, frame.hold, i ));
+        r = q->read_lock( q, CLIENT, any, false );
+        assert( i == r.sequence );
+        assert( 0 == q->unlock( q, r.hold ));
+    }
+    ionized_queue_lock const replay = q->replay_lock( q, CLIENT, any, 0U );
+    assert( 0 == replay.status );
+    assert(( 2U == replay.sequence ) && ( 2U == replay.size ));
+    ionized_queue_lock const newer = q->replay_lock( q, CLIENT, any, 3U );
+    assert( 3U == newer.sequence );
+    assert( 0 == q->unlock( q, newer.hold ));
+    assert( ENOENT == q->replay_lock( q, CLIENT, any, 4U ).status );
+    assert( 3U == q->stats( q, false ).free );
+    /* writers skip replayed buffers, reuse others oldest first */
+    ionized_queue_lock const w1 = q->write_lock( q, CLIENT, any, false );
+    ionized_queue_lock const w2 = q->write_lock( q, CLIENT, any, false );
+    assert(( 0 == w1.status ) && ( 0 == w2.status ));
+    assert(( replay.hold != w1.hold ) && ( replay.hold != w2.hold ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->unlock( q, replay.hold ));
+    assert( EPERM == q->unlock( q, replay.hold ));
+    assert( 0 == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* buffer moves between queues without copying */
+    setup = ionized_queue_setup( 5U, 0U, NULL );
+    ionized_queue_setup_result downstream =
+        ionized_queue_setup( 6U, 0U, NULL );
+    assert(( 0 == setup.status ) && ( 0 == downstream.status ));
+    ionized_queue * const target = &( downstream.queue );
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    memcpy( frame.data, "plasma", 6U );
+    assert( 0 == q->commit( q, frame.hold, 6U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( EAGAIN == ionized_queue_transfer( q, r.hold, target, 3U ));
+    assert( EPERM == ionized_queue_transfer( q, r.hold, target, 3U ));
+    assert( 0 == target->allocate( target, CLIENT, properties, 1U, 0U ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->commit( q, frame.hold, 6U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( EINVAL == ionized_queue_transfer( q, r.hold, q, 3U ));
+    assert( ERANGE ==
+            ionized_queue_transfer( q, r.hold, target, BUFSIZE + 1U ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->commit( q, frame.hold, 6U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    void * const moved = r.data;
+    memcpy( r.data, "PLASMA", 6U );
+    assert( 0 == ionized_queue_transfer( q, r.hold, target, 3U ));
+    ionized_queue_lock const forwarded =
+        target->read_lock( target, CLIENT, any, false );
+    assert(( moved == forwarded.data ) && ( 3U == forwarded.size ));
+    assert( 0 == memcmp( forwarded.data, "PLA", 3U ));
+    assert( 0 == target->unlock( target, forwarded.hold ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    assert(( 0 == frame.status ) && ( moved != frame.data ));
+    assert( 1U == q->stats( q, false ).buffers );
+    assert( BUFSIZE == target->stats( target, false ).bytes );
+    assert( 0 == ionized_queue_cleanup( target ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* published buffer is reused only after every queue consumed it */
+    setup = ionized_queue_setup( 7U, 0U, NULL );
+    ionized_queue_setup_result fanout[ 2 ] =
+    {
+        ionized_queue_setup( 8U, 0U, NULL ),
+        ionized_queue_setup( 9U, 0U, NULL )
+    };
+    ionized_queue * const targets[] = { &( fanout[ 0 ].queue ),
+        &( fanout[ 1 ].queue ) };
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    memcpy( frame.data, "fanout", 6U );
+    assert( EINVAL == ionized_queue_publish( q, frame.hold, &q, 1U, 6U ));
+    assert( 0 == ionized_queue_publish( q, frame.hold, targets, 2U, 6U ));
+    assert( EPERM == ionized_queue_publish( q, frame.hold, targets, 2U, 6U ));
+    for( size_t i = 0U; i < 2U; ++i )
+    {
+        r = targets[ i ]->read_lock( targets[ i ], CLIENT, any, false );
+        assert(( frame.data == r.data ) && ( 6U == r.size ));
+        assert( 0 == targets[ i ]->unlock( targets[ i ], r.hold ));
+        assert( 0U == targets[ i ]->stats( targets[ i ], false ).bytes );
+        assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    }
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == memcmp( r.data, "fanout", 6U ));
+    assert( 0 == q->unlock( q, r.hold ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == ionized_queue_publish( q, frame.hold, targets, 2U, 1U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == ionized_queue_cleanup( targets[ 0 ] ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == ionized_queue_cleanup( targets[ 1 ] ));
+    assert( 0 == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* snapshot keeps last committed data while writers go around it */
+    setup = ionized_queue_setup( 10U, 0U, NULL );
+    assert( 0 == q->allocate( q, CLIENT, properties, 2U, 0U ));
+    assert( EAGAIN == q->snapshot_lock( q, CLIENT, any ).status );
+    frame = q->write_lock( q, CLIENT, any, false );
+    memcpy( frame.data, "scan", 4U );
+    assert( 0 == q->commit( q, frame.hold, 4U ));
+    ionized_queue_lock const snapshot = q->snapshot_lock( q, CLIENT, any );
+    assert(( 0 == snapshot.status ) && ( frame.data == snapshot.data ));
+    ionized_queue_lock const another = q->snapshot_lock( q, CLIENT, any );
+    assert(( 0 == another.status ) && ( snapshot.data == another.data ));
+    assert( snapshot.hold != another.hold );
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( frame.hold == r.hold );
+    assert( 0 == q->unlock( q, r.hold ));
+    for( unsigned int i = 0U; i < 3U; ++i )
+    {
+        frame = q->write_lock( q, CLIENT, any, false );
+        assert(( 0 == frame.status ) && ( snapshot.data != frame.data ));
+        assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+        assert( 0 == q->commit( q, frame.hold, 1U ));
+        r = q->read_lock( q, CLIENT, any, false );
+        assert( 0 == q->unlock( q, r.hold ));
+    }
+    assert( 0 == memcmp( snapshot.data, "scan", 4U ));
+    /* releasing one snapshot twice leaves the other one pinned */
+    assert( 0 == q->unlock( q, snapshot.hold ));
+    assert( EPERM == q->unlock( q, snapshot.hold ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    assert(( 0 == frame.status ) && ( another.data != frame.data ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->abandon( q, frame.hold, 0U ));
+    assert( 0 == q->unlock( q, another.hold ));
+    assert( EPERM == q->unlock( q, another.hold ));
+    assert( 0 == q->shrink( q, 2U ));
+    assert( 0U == q->stats( q, false ).buffers );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* readers get most urgent buffer first */
+    setup = ionized_queue_setup( 11U, 0U, NULL );
+    assert( 0 == q->configure(
+                q,
+                ( plasma_config ) { PLASMA_CONFIG_PRIORITY } ));
+    plasma_properties const five[] =
+    {
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U }
+    };
+    assert( 0 == q->allocate( q, CLIENT, five, 5U, 0U ));
+    plasma_tag const tags[] =
+    {
+        { 0U, 0U }, /* bulk */
+        { 0U, 200U },
+        { 1U, 0U },
+        { 0U, 100U },
+        { 0U, 0U }
+    };
+    size_t const order[] = { 3U, 4U, 2U, 1U, 5U };
+    assert( EPERM == q->tag( q, 0U, tags[ 0 ] ));
+    for( size_t i = 0U; i < 5U; ++i )
+    {
+        frame = q->write_lock( q, CLIENT, any, false );
+        assert( 0 == q->tag( q, frame.hold, tags[ i ] ));
+        assert( 0 == q->commit( q, frame.hold, i + 1U ));
+    }
+    for( size_t i = 0U; i < 5U; ++i )
+    {
+        r = q->read_lock( q, CLIENT, any, false );
+        assert( order[ i ] == r.size );
+        assert( 0 == q->unlock( q, r.hold ));
+    }
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* producers append to the same buffer, readable once full or flushed */
+    setup = ionized_queue_setup( 12U, 0U, NULL );
+    assert( 0 == q->allocate( q, CLIENT, properties, 2U, 0U ));
+    assert( EINVAL == q->append( q, CLIENT, 0U ).status );
+    assert( ENOENT == q->append( q, CLIENT, BUFSIZE + 1U ).status );
+    ionized_queue_lock records[ 4 ];
+    for( size_t i = 0U; i < 3U; ++i )
+    {
+        records[ i ] = q->append( q, CLIENT, 1000U );
+        assert( 0 == records[ i ].status );
+        assert( 1000U * i == records[ i ].offset );
+        assert( records[ 0 ].fd == records[ i ].fd );
+        memset( records[ i ].data, 'a' + ( int ) i, 1000U );
+    }
+    /* doesn't fit, so the first buffer is sealed and second one opened */
+    records[ 3 ] = q->append( q, CLIENT, 2000U );
+    assert( 0 == records[ 3 ].status );
+    assert( 0U == records[ 3 ].offset );
+    assert( records[ 0 ].fd != records[ 3 ].fd );
+    assert( EPERM == q->unlock( q, records[ 0 ].hold ));
+    assert( 0 == q->commit( q, records[ 2 ].hold, 1000U ));
+    assert( 0 == q->commit( q, records[ 0 ].hold, 1000U ));
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->commit( q, records[ 1 ].hold, 1000U ));
+    assert( EPERM == q->commit( q, records[ 1 ].hold, 1000U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    assert( 3000U == r.size );
+    uint8_t const * const appended = r.data;
+    assert(( 'a' == appended[ 0 ] ) && ( 'c' == appended[ 2999 ] ));
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == q->commit( q, records[ 3 ].hold, 2000U ));
+    assert( 0 == q->flush( q, false ));
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->flush( q, true ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 2000U == r.size );
+    assert( 0 == q->unlock( q, r.hold ));
+    /* buffer older than the timeout is sealed by the next append */
+    assert( 0 == q->flush_timeout( q, 1U ));
+    records[ 0 ] = q->append( q, CLIENT, 10U );
+    records[ 1 ] = q->append( q, CLIENT, 10U );
+    assert( 0U == records[ 1 ].offset );
+    assert( 0 == q->commit( q, records[ 0 ].hold, 10U ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 10U == r.size );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* oversized reservations can't wrap the offset of the open buffer */
+    setup = ionized_queue_setup( 16U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    records[ 0 ] = q->append( q, CLIENT, 64U );
+    assert( 0U == records[ 0 ].offset );
+    assert( ERANGE == q->append( q, CLIENT, SIZE_MAX ).status );
+    assert( ERANGE == q->append( q, CLIENT, BUFSIZE + 1U ).status );
+    records[ 1 ] = q->append( q, CLIENT, 64U );
+    assert( 64U == records[ 1 ].offset );
+    /* reservation ending exactly at capacity seals the buffer */
+    records[ 2 ] = q->append( q, CLIENT, BUFSIZE - 128U );
+    assert( 0 == records[ 2 ].status );
+    assert( 128U == records[ 2 ].offset );
+    assert( BUFSIZE - 128U == records[ 2 ].size );
+    for( size_t i = 0U; i < 3U; ++i )
+    {
+        assert( 0 == q->commit( q, records[ i ].hold, records[ i ].size ));
+    }
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( BUFSIZE == r.size );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* only buffers which stayed free long enough are pruned */
+    setup = ionized_queue_setup( 17U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->allocate( q, CLIENT, properties, 2U, 0U ));
+    assert( EINVAL == q->prune( NULL, 1U, 0U ).status );
+    ionized_queue_prune_result pruned = q->prune( q, 2U, UINT64_MAX );
+    assert(( 0 == pruned.status ) && ( 0U == pruned.count ));
+    r = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    pruned = q->prune( q, 2U, 0U );
+    assert(( 0 == pruned.status ) && ( 1U == pruned.count ));
+    assert( 1U == q->stats( q, false ).buffers );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* configuration changed while buffers were mapped fails allocation */
+    ionized_quota meddling = { NULL, NULL, reconfigure, reconfigure, NULL };
+    setup = ionized_queue_setup( 18U, 0U, &meddling );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure( q, ( plasma_config ) { 0U } ));
+    racing = q;
+    assert( EAGAIN == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    assert( 0U == q->stats( q, false ).buffers );
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    r = q->write_lock( q, CLIENT, any, false );
+    assert( sizeof( plasma_header ) == r.offset );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* locks held past their lease are revoked, late holders are told */
+    setup = ionized_queue_setup( 13U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure( q, ( plasma_config ) { 0U } ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    ionized_queue_lock const stuck = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == stuck.status );
+    assert( 0 == q->expire( q ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->lease( q, 1U ));
+    assert( 0 == q->expire( q ));
+    assert( 1U == q->stats( q, false ).revoked );
+    assert( ETIMEDOUT == q->commit( q, stuck.hold, 1U ));
+    assert( ETIMEDOUT == q->unlock( q, stuck.hold ));
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    ionized_queue_lock const fresh = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == fresh.status );
+    assert( fresh.hold != stuck.hold );
+    assert( 0 == q->unlock( q, fresh.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    assert( 0 == q->expire( q ));
+    assert( 2U == q->stats( q, false ).revoked );
+    assert( ETIMEDOUT == q->unlock( q, r.hold ));
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    assert( 0 == q->lease( q, 0U ));
+    ionized_queue_lock const spared = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->expire( q ));
+    assert( 0 == q->unlock( q, spared.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* readers sharing a buffer share its lease, they lose it together */
+    setup = ionized_queue_setup( 19U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure( q, ( plasma_config ) { PLASMA_CONFIG_LATEST } ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 2U, 0U ));
+    frame = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == q->commit( q, frame.hold, 1U ));
+    ionized_queue_lock const early = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->lease( q, 1U ));
+    ionized_queue_lock const late = q->read_lock( q, CLIENT, any, false );
+    assert(( 0 == late.status ) && ( early.hold == late.hold ));
+    assert( 0 == q->expire( q ));
+    assert( 1U == q->stats( q, false ).revoked );
+    assert( ETIMEDOUT == q->unlock( q, late.hold ));
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* pages of prefaulted buffers are populated by workers of the pool */
+    setup = ionized_queue_setup( 14U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure( q, ( plasma_config ) { 0U } ));
+    uint32_t const unknown = ~IONIZED_BUFFER_FLAGS;
+    assert( ENOTSUP == q->allocate( q, CLIENT, properties, 1U, unknown ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    size_t const cold = q->stats( q, false ).cold;
+    assert( 1U == cold );
+    ionized_pool_setup_result pool = ionized_pool_setup( 2U, 1U );
+    assert( 0 == pool.status );
+    assert( 0 == q->offload( q, &( pool.pool ), 0U ));
+    plasma_properties const large[] =
+    {
+        { LARGE, LARGE, 1U },
+        { LARGE, LARGE, 1U }
+    };
+    uint32_t const flags = IONIZED_BUFFER_PREFAULT;
+    assert( 0 == q->allocate( q, CLIENT, large, 2U, flags ));
+    /* writers get the buffers only once the pool is done with them */
+    for( ;; )
+    {
+        ionized_queue_stats const filling = q->stats( q, false );
+        assert( 3U == filling.free + filling.populating );
+        if( 0U == filling.populating )
+        {
+            break;
+        }
+    }
+    assert( cold == q->stats( q, false ).cold );
+    /* locking may be forbidden by RLIMIT_MEMLOCK, such buffers are retired */
+    assert( 0 == q->allocate( q, CLIENT, large, 1U, IONIZED_BUFFER_MLOCK ));
+    while( 0U < q->stats( q, false ).populating )
+    {
+    }
+    assert( cold == q->stats( q, false ).cold );
+    assert( 0 == q->offload( q, NULL, 0U ));
+    assert( 0 == q->allocate( q, CLIENT, large, 1U, flags ));
+    assert( cold == q->stats( q, false ).cold );
+    /* sweeps return pages of the plain buffer only */
+    ionized_queue_reclamation const idle = { 1U, false };
+    assert( 0 == q->reclamation( q, idle ));
+    assert( 0 == q->reclaim( q ));
+    assert( 0 == q->trim( q ));
+    assert( 1U == q->stats( q, false ).reclaimed );
+    assert( cold == q->stats( q, false ).cold );
+    assert( 0 == ionized_queue_cleanup( q ));
+
+    /* free buffers are zeroed by sweeps, pages of idle ones are returned */
+    setup = ionized_queue_setup( 15U, 0U, NULL );
+    assert( 0 == setup.status );
+    assert( 0 == q->configure( q, ( plasma_config ) { 0U } ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    ionized_queue_reclamation policy = { 0U, true };
+    assert( 0 == q->reclamation( q, policy ));
+    assert( 0 == q->reclaim( q ));
+    assert( 0U == q->stats( q, false ).scrubbed );
+    ionized_queue_lock z = q->write_lock( q, CLIENT, any, false );
+    memset( z.data, 0xAB, z.size );
+    assert( 0 == q->commit( q, z.hold, z.size ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == q->reclaim( q ));
+    assert( 1U == q->stats( q, false ).scrubbed );
+    /* scrubbed buffer isn't the latest contents any more */
+    assert( EAGAIN == q->snapshot_lock( q, CLIENT, any ).status );
+    z = q->write_lock( q, CLIENT, any, false );
+    assert( 0U == (( uint8_t * ) z.data )[ 0 ] );
+    memset( z.data, 0xAB, z.size );
+    assert( 0 == q->unlock( q, z.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, r.hold ));
+    z = q->write_lock( q, CLIENT, any, false );
+    assert( 1U == q->stats( q, false ).scrubbed_inline );
+    assert( 0U == (( uint8_t * ) z.data )[ z.size - 1U ] );
+    memset( z.data, 0xAB, z.size );
+    assert( 0 == q->unlock( q, z.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, r.hold ));
+    policy = ( ionized_queue_reclamation ) { 1U, false };
+    assert( 0 == q->reclamation( q, policy ));
+    assert( 0U == q->stats( q, false ).cold );
+    assert( 0 == q->reclaim( q ));
+    assert( 0 == q->reclaim( q ));
+    assert( 1U == q->stats( q, false ).reclaimed );
+    assert( 1U == q->stats( q, false ).cold );
+    z = q->write_lock( q, CLIENT, any, false );
+    assert( 0U == (( uint8_t * ) z.data )[ 0 ] );
+    memset( z.data, 0xAB, z.size );
+    assert( 0 == q->unlock( q, z.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, r.hold ));
+    policy = ( ionized_queue_reclamation ) { 0U, true };
+    assert( 0 == q->reclamation( q, policy ));
+    assert( 0 == q->offload( q, &( pool.pool ), 0U ));
+    assert( 0 == q->reclaim( q ));
+    while( 2U > q->stats( q, false ).scrubbed )
+    {
+    }
+    z = q->write_lock( q, CLIENT, any, false );
+    assert( 1U == q->stats( q, false ).scrubbed_inline );
+    assert( 0U == (( uint8_t * ) z.data )[ 0 ] );
+    assert( 0 == q->unlock( q, z.hold ));
+    r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == q->reclaim( q ));
+    assert( 0 == ionized_queue_cleanup( q ));
+    assert( 0 == ionized_pool_cleanup( &( pool.pool )));
+    return 0;
+}
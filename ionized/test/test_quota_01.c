@@ -0,0 +1,100 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_quota and queue backpressure.
+ * \date        10/20/2026 01:37:12 PM
+ * \file        test_quota_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/queue.h>
+#include <ionized/quota.h>
+#include <plasma/properties.h>
+#include <stddef.h>
+
+#define BUFSIZE 4096U
+#define UID 1U
+#define CLIENT 7U
+#define OTHER 8U
+
+static plasma_properties const any = { 1U, BUFSIZE, 1U };
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_quota_setup_result setup = ionized_quota_setup( 0U, 3U * BUFSIZE );
+    assert( 0 == setup.status );
+    ionized_quota * const quota = &( setup.quota );
+
+    /* budgets on their own */
+    assert( EINVAL == quota->set( NULL, IONIZED_QUOTA_UID, UID, 1U ));
+    assert( EINVAL == quota->set( quota, IONIZED_QUOTA_CLIENT + 1, UID, 1U ));
+    assert( 3U * BUFSIZE == quota->usage(
+                quota, IONIZED_QUOTA_CLIENT, CLIENT ).limit );
+    assert( 0U == quota->usage( quota, IONIZED_QUOTA_UID, UID ).limit );
+    assert( 0 == quota->charge( quota, UID, CLIENT, 3U * BUFSIZE ));
+    assert( EDQUOT == quota->charge( quota, UID, CLIENT, 1U ));
+    /* the daemon itself has no client budget */
+    assert( 0 == quota->charge( quota, UID, IONIZED_QUOTA_DAEMON, BUFSIZE ));
+    assert( 4U * BUFSIZE == quota->usage(
+                quota, IONIZED_QUOTA_UID, UID ).used );
+    assert( 0 == quota->refund( quota, UID, CLIENT, 3U * BUFSIZE ));
+    assert( 0 == quota->refund( quota, UID, IONIZED_QUOTA_DAEMON, BUFSIZE ));
+    assert( 0U == quota->usage( quota, IONIZED_QUOTA_UID, UID ).used );
+    assert( 0U == quota->usage( quota, IONIZED_QUOTA_CLIENT, CLIENT ).used );
+
+    /* queue charges allocations and refunds retired buffers */
+    assert( 0 == quota->set( quota, IONIZED_QUOTA_UID, UID, 4U * BUFSIZE ));
+    ionized_queue_setup_result queue = ionized_queue_setup( UID, 0U, quota );
+    assert( 0 == queue.status );
+    ionized_queue * const q = &( queue.queue );
+    plasma_properties const properties[] =
+    {
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U }
+    };
+    assert( EDQUOT == q->allocate( q, CLIENT, properties, 4U, 0U ));
+    assert( 0U == q->stats( q, false ).buffers );
+    assert( 0 == q->allocate( q, CLIENT, properties, 3U, 0U ));
+    assert( EDQUOT == q->allocate( q, OTHER, properties, 2U, 0U ));
+    assert( 0 == q->allocate( q, OTHER, properties, 1U, 0U ));
+    assert(
+        EDQUOT == q->allocate( q, IONIZED_QUOTA_DAEMON, properties, 1U, 0U )
+    );
+    assert( BUFSIZE == quota->usage(
+                quota, IONIZED_QUOTA_CLIENT, OTHER ).used );
+    assert( 0 == q->shrink( q, 1U ));
+    assert( 4U * BUFSIZE > quota->usage( quota, IONIZED_QUOTA_UID, UID ).used );
+
+    /* writers are held back while readers lag */
+    assert( 0 == q->backpressure( q, 2U * BUFSIZE ));
+    ionized_queue_lock w = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == w.status );
+    assert( 0 == q->unlock( q, w.hold ));
+    assert( 0 == ( w = q->write_lock( q, CLIENT, any, false )).status );
+    assert( 0 == q->unlock( q, w.hold ));
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+    ionized_queue_stats const stats = q->stats( q, false );
+    assert( 1U == stats.free );
+    assert( 1U == stats.write_backpressured );
+    assert( 0U == stats.write_eagains );
+    ionized_queue_lock const r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    assert( 0 == q->unlock( q, r.hold ));
+    assert( 0 == ( w = q->write_lock( q, CLIENT, any, false )).status );
+    assert( 0 == q->unlock( q, w.hold ));
+
+    assert( 0 == ionized_queue_cleanup( q ));
+    assert( 0U == quota->usage( quota, IONIZED_QUOTA_UID, UID ).used );
+    assert( 0U == quota->usage( quota, IONIZED_QUOTA_CLIENT, CLIENT ).used );
+    assert( 0 == ionized_quota_cleanup( quota ));
+    return 0;
+}
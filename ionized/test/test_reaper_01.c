@@ -0,0 +1,132 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_reaper.
+ * \date        10/23/2026 11:40:02 AM
+ * \file        test_reaper_01.c
+ * \version     1.0
+ *
+ * The client is a forked child, which exits once its pipe is closed.
+ **/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/loop.h>
+#include <ionized/queue.h>
+#include <ionized/reaper.h>
+#include <plasma/config.h>
+#include <plasma/properties.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BUFSIZE 4096U
+#define CLIENT 7U
+#define OTHER 8U
+
+static plasma_properties const any = { 1U, BUFSIZE, 1U };
+
+static pid_t spawn( int * const pipe_end )
+{
+    int ends[ 2 ];
+    assert( 0 == pipe( ends ));
+    pid_t const pid = fork();
+    assert( -1 != pid );
+    if( 0 == pid )
+    {
+        char byte;
+        UNUSED( close( ends[ 1 ] ));
+        UNUSED( read( ends[ 0 ], &byte, 1U ));
+        _exit( 0 );
+    }
+    UNUSED( close( ends[ 0 ] ));
+    *pipe_end = ends[ 1 ];
+    return pid;
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_queue_setup_result qs = ionized_queue_setup( 1U, 0U, NULL );
+    assert( 0 == qs.status );
+    ionized_queue * const q = &( qs.queue );
+    plasma_properties const properties[] = { { BUFSIZE, BUFSIZE, 1U } };
+    assert( 0 == q->configure( q, ( plasma_config ) { 0U } ));
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+
+    ionized_loop_setup_result ls = ionized_loop_setup();
+    assert( 0 == ls.status );
+    ionized_loop * const loop = &( ls.loop );
+    assert( EINVAL == ionized_reaper_setup( NULL ).status );
+    ionized_reaper_setup_result rs = ionized_reaper_setup( loop );
+    assert( 0 == rs.status );
+    ionized_reaper * const reaper = &( rs.reaper );
+
+    int pipe_end;
+    pid_t const pid = spawn( &pipe_end );
+    assert( ENOENT == reaper->hold( reaper, CLIENT, q, 1U, 0U ));
+    assert( 0 == reaper->track( reaper, CLIENT, pid ));
+    assert( EEXIST == reaper->track( reaper, CLIENT, pid ));
+    assert( 1U == loop->watched( loop ));
+
+    /* released locks are forgotten */
+    ionized_queue_lock w = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == w.status );
+    assert( 0 == reaper->hold( reaper, CLIENT, q, w.hold, 0U ));
+    assert( 0 == q->unlock( q, w.hold ));
+    assert( 0 == reaper->release( reaper, CLIENT, q, w.hold ));
+    assert( ENOENT == reaper->release( reaper, CLIENT, q, w.hold ));
+    ionized_queue_lock const r = q->read_lock( q, CLIENT, any, false );
+    assert( 0 == r.status );
+    assert( 0 == q->unlock( q, r.hold ));
+
+    /* lock of a live client is kept */
+    w = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == w.status );
+    assert( 0 == reaper->hold( reaper, CLIENT, q, w.hold, 0U ));
+    assert( 0 == loop->run( loop, 0 ).status );
+    assert( 0U == reaper->stats( reaper ).reaped );
+    assert( EAGAIN == q->write_lock( q, CLIENT, any, false ).status );
+
+    /* dead client's lock is abandoned, write discarded */
+    UNUSED( close( pipe_end ));
+    while( 0U == reaper->stats( reaper ).reaped )
+    {
+        assert( 0 == loop->run( loop, 100 ).status );
+    }
+    ionized_reaper_stats const stats = reaper->stats( reaper );
+    assert( 1U == stats.abandoned );
+    assert( 0U == stats.tracked );
+    assert( 0U == loop->watched( loop ));
+    assert( EAGAIN == q->read_lock( q, CLIENT, any, false ).status );
+    w = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == w.status );
+    assert( 0 == q->unlock( q, w.hold ));
+    assert( pid == waitpid( pid, NULL, 0 ));
+    assert( ESRCH == reaper->track( reaper, CLIENT, pid ));
+
+    /* disconnected client's locks are abandoned too */
+    pid_t const other = spawn( &pipe_end );
+    assert( 0 == reaper->track( reaper, OTHER, other ));
+    ionized_queue_lock const kept = q->read_lock( q, OTHER, any, false );
+    assert( 0 == kept.status );
+    assert( 0 == reaper->hold( reaper, OTHER, q, kept.hold, 0U ));
+    assert( 0 == reaper->untrack( reaper, OTHER ));
+    assert( ENOENT == reaper->untrack( reaper, OTHER ));
+    assert( 2U == reaper->stats( reaper ).abandoned );
+    assert( 1U == reaper->stats( reaper ).reaped );
+    assert( EPERM == q->unlock( q, kept.hold ));
+    UNUSED( close( pipe_end ));
+    assert( other == waitpid( other, NULL, 0 ));
+
+    assert( 0 == ionized_reaper_cleanup( reaper ));
+    assert( 0 == ionized_loop_cleanup( loop ));
+    assert( 0 == ionized_queue_cleanup( q ));
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionized_shard.
+ * \date        10/21/2026 05:14:09 PM
+ * \file        test_shard_01.c
+ * \version     1.0
+ *
+ * Uses pthreads.
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/queue.h>
+#include <ionized/reaper.h>
+#include <ionized/shard.h>
+#include <plasma/properties.h>
+#include <plasma/shard.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define SHARDS 4U
+#define BUFSIZE 4096U
+#define CLIENT 7U
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( EINVAL ==
+            ionized_shard_setup( SHARDS, SHARDS, -1, 0U, NULL ).status );
+    ionized_shard_setup_result setup[ SHARDS ];
+    for( uint32_t i = 0U; i < SHARDS; ++i )
+    {
+        /* every worker pinned to the first core, it's always there */
+        setup[ i ] = ionized_shard_setup( i, SHARDS, 0, 0U, NULL );
+        assert( 0 == setup[ i ].status );
+    }
+
+    /* each uid is served only by its owner */
+    uint32_t const uid = 1234U;
+    uint32_t const index = plasma_shard( uid, SHARDS );
+    ionized_shard * const owner = &( setup[ index ].shard );
+    ionized_shard * const other = &( setup[ ( index + 1U ) % SHARDS ].shard );
+    assert( EXDEV == other->queue( other, uid ).status );
+    ionized_shard_queue_result const found = owner->queue( owner, uid );
+    assert( 0 == found.status );
+    assert( found.queue == owner->queue( owner, uid ).queue );
+    for( uint32_t i = 0U; i < 100U; ++i )
+    {
+        ionized_shard * const s = &( setup[ plasma_shard( i, SHARDS )].shard );
+        assert( 0 == s->queue( s, i ).status );
+    }
+    assert( found.queue == owner->queue( owner, uid ).queue );
+    assert( NULL != owner->loop( owner ));
+
+    /* clients of the shard are tracked by its own reaper */
+    ionized_reaper * const reaper = owner->reaper( owner );
+    assert(( NULL != reaper ) && ( NULL == owner->reaper( NULL )));
+    assert( 0 == reaper->track( reaper, CLIENT, getpid()));
+    assert( 1U == reaper->stats( reaper ).tracked );
+
+    /* workers run on their own and flush appends when stopped */
+    ionized_queue * const q = found.queue;
+    plasma_properties const properties[] = { { BUFSIZE, BUFSIZE, 1U } };
+    assert( 0 == q->allocate( q, CLIENT, properties, 1U, 0U ));
+    ionized_queue_lock const record = q->append( q, CLIENT, 16U );
+    assert( 0 == record.status );
+    assert( 0 == q->commit( q, record.hold, 16U ));
+    for( uint32_t i = 0U; i < SHARDS; ++i )
+    {
+        ionized_shard * const s = &( setup[ i ].shard );
+        assert( ENOENT == s->stop( s ));
+        assert( 0 == s->start( s ));
+        assert( EBUSY == s->start( s ));
+    }
+    assert( 0 == owner->stop( owner ));
+    ionized_queue_lock const r =
+        q->read_lock( q, CLIENT, properties[ 0 ], false );
+    assert( 16U == r.size );
+    assert( 0 == q->unlock( q, r.hold ));
+
+    /* cleanup stops the remaining workers */
+    for( uint32_t i = 0U; i < SHARDS; ++i )
+    {
+        assert( 0 == ionized_shard_cleanup( &( setup[ i ].shard )));
+    }
+    assert( EINVAL == ionized_shard_cleanup( &( setup[ 0 ].shard )));
+
+    /* worker isn't started at all when it can't be pinned to its core */
+    ionized_shard_setup_result lost =
+        ionized_shard_setup( 0U, 1U, 1023, 0U, NULL );
+    assert( 0 == lost.status );
+    assert( 0 != lost.shard.start( &( lost.shard )));
+    assert( ENOENT == lost.shard.stop( &( lost.shard )));
+    assert( 0 == ionized_shard_cleanup( &( lost.shard )));
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests watermark subscriptions of ionized_queue.
+ * \date        10/20/2026 04:02:17 PM
+ * \file        test_watermark_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/universal.h>
+#include <ionized/queue.h>
+#include <plasma/properties.h>
+#include <plasma/watermark.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define BUFSIZE 4096U
+#define CLIENT 7U
+
+static plasma_properties const any = { 1U, BUFSIZE, 1U };
+
+/* returns number of crossings signalled since last call */
+static uint64_t crossings( int const fd )
+{
+    struct pollfd p = { .fd = fd, .events = POLLIN, .revents = 0 };
+    if( 0 == poll( &p, 1U, 0 ))
+    {
+        return 0U;
+    }
+    uint64_t count = 0U;
+    assert( sizeof( count ) == read( fd, &count, sizeof( count )));
+    return count;
+}
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    ionized_queue_setup_result setup = ionized_queue_setup( 1U, 0U, NULL );
+    assert( 0 == setup.status );
+    ionized_queue * const q = &( setup.queue );
+    plasma_properties const properties[] =
+    {
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U },
+        { BUFSIZE, BUFSIZE, 1U }
+    };
+    assert( 0 == q->allocate( q, CLIENT, properties, 4U, 0U ));
+
+    plasma_watermark const low =
+        { PLASMA_WATERMARK_WRITABLE_BELOW, 50U, PLASMA_WATERMARK_PERCENT };
+    plasma_watermark const high =
+        { PLASMA_WATERMARK_READABLE_ABOVE, 1U, PLASMA_WATERMARK_BUFFERS };
+    assert( ERANGE == q->subscribe( q, ( plasma_watermark ) {
+                PLASMA_WATERMARK_WRITABLE_BELOW,
+                101U,
+                PLASMA_WATERMARK_PERCENT
+    } ).status );
+    ionized_queue_subscription const writable = q->subscribe( q, low );
+    ionized_queue_subscription const readable = q->subscribe( q, high );
+    assert(( 0 == writable.status ) && ( 0 == readable.status ));
+    assert( 0U == crossings( writable.fd ));
+    assert( 0U == crossings( readable.fd ));
+
+    /* three of four buffers taken, fewer than half left for writers */
+    ionized_queue_lock w[ 3 ];
+    for( unsigned int i = 0U; i < 3U; ++i )
+    {
+        w[ i ] = q->write_lock( q, CLIENT, any, false );
+        assert( 0 == w[ i ].status );
+    }
+    assert( 1U == crossings( writable.fd ));
+    assert( 0U == crossings( writable.fd ));
+
+    /* two readable buffers cross the high watermark only once */
+    assert( 0 == q->unlock( q, w[ 0 ].hold ));
+    assert( 0U == crossings( readable.fd ));
+    assert( 0 == q->unlock( q, w[ 1 ].hold ));
+    assert( 0 == q->unlock( q, w[ 2 ].hold ));
+    assert( 1U == crossings( readable.fd ));
+
+    /* conditions stop holding and start again */
+    for( unsigned int i = 0U; i < 3U; ++i )
+    {
+        ionized_queue_lock const r = q->read_lock( q, CLIENT, any, false );
+        assert( 0 == r.status );
+        assert( 0 == q->unlock( q, r.hold ));
+    }
+    assert( 0U == crossings( writable.fd ));
+    assert( 0U == crossings( readable.fd ));
+    assert( 0 == q->shrink( q, 3U ));
+    assert( 0U == crossings( writable.fd ));
+    ionized_queue_lock const last = q->write_lock( q, CLIENT, any, false );
+    assert( 0 == last.status );
+    assert( 1U == crossings( writable.fd ));
+
+    /* subscribing while condition holds signals at once */
+    ionized_queue_subscription const late = q->subscribe( q, low );
+    assert( 0 == late.status );
+    assert( 1U == crossings( late.fd ));
+
+    assert( 0 == q->unsubscribe( q, readable.fd ));
+    assert( ENOENT == q->unsubscribe( q, readable.fd ));
+    assert( 0 == q->unsubscribe( q, late.fd ));
+    assert( 0 == ionized_queue_cleanup( q ));
+    return 0;
+}
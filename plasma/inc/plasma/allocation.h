@@ -0,0 +1,55 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Defines options of buffer allocation.
+ * \date        10/24/2026 09:05:42 AM
+ * \file        allocation.h
+ * \version     1.0
+ *
+ * Flags passed with plasma_allocate_func describe how the service backs the
+ * memory of new buffers, as opposed to plasma_properties, which describe
+ * their sizes.
+ **/
+
+#ifndef PLASMA_ALLOCATION_H__
+# define PLASMA_ALLOCATION_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Options of buffer allocation.
+ */
+typedef enum
+{
+    /**
+     * Pages are allocated before allocate returns, as with MAP_POPULATE, so
+     * the first write to the buffer doesn't fault.
+     */
+    PLASMA_ALLOCATION_PREFAULT = 1U << 0,
+    /**
+     * Pages are locked in memory, never swapped out. Fails with ENOMEM or
+     * EPERM past the service's RLIMIT_MEMLOCK.
+     */
+    PLASMA_ALLOCATION_MLOCK = 1U << 1
+}
+plasma_allocation_flag;
+
+/**
+ * \brief Mask of all flags known to this version of plasma.
+ */
+# define PLASMA_ALLOCATION_FLAGS (( uint32_t ) ( \
+    PLASMA_ALLOCATION_PREFAULT \
+    | PLASMA_ALLOCATION_MLOCK \
+))
+
+/**
+ * \brief Checks whether allocation flags don't contain errors.
+ * \param flags Bitwise or of plasma_allocation_flag values.
+ * \return Zero if flags are valid, error code otherwise.
+ *
+ * Error codes that can be returned:
+ * 1. ENOTSUP - flags contain values unknown to this version of plasma.
+ */
+ionize_status plasma_allocation_validator( uint32_t const flags );
+
+#endif /* PLASMA_ALLOCATION_H__ */
@@ -0,0 +1,71 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Defines configuration of the circular queue.
+ * \date        10/19/2026 09:31:17 AM
+ * \file        config.h
+ * \version     1.0
+ *
+ * The plasma_config object describes behaviour of the whole circular queue,
+ * as opposed to plasma_properties, which describe single memory buffers.
+ **/
+
+#ifndef PLASMA_CONFIG_H__
+# define PLASMA_CONFIG_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Optional features of the circular queue.
+ */
+typedef enum
+{
+    /** Each buffer starts with plasma_header filled by the service. */
+    PLASMA_CONFIG_HEADER = 1U << 0,
+    /** Writers with no free buffer overwrite the oldest unread one. */
+    PLASMA_CONFIG_OVERWRITE = 1U << 1,
+    /**
+     * Triple buffer: readers get the most recently committed buffer, which
+     * stays readable until superseded, and never hold the writer back.
+     */
+    PLASMA_CONFIG_LATEST = 1U << 2,
+    /** Readers get the most urgent buffer, as ordered by plasma_tag. */
+    PLASMA_CONFIG_PRIORITY = 1U << 3
+}
+plasma_config_flag;
+
+/**
+ * \brief Mask of all flags known to this version of plasma.
+ */
+# define PLASMA_CONFIG_FLAGS (( uint32_t ) ( \
+    PLASMA_CONFIG_HEADER \
+    | PLASMA_CONFIG_OVERWRITE \
+    | PLASMA_CONFIG_LATEST \
+    | PLASMA_CONFIG_PRIORITY \
+))
+
+/**
+ * \brief Configuration of the circular queue.
+ * \see plasma_config_flag
+ *
+ * Zero-initialized structure describes the default queue.
+ */
+typedef struct
+{
+    uint32_t flags; /** Bitwise or of plasma_config_flag values. */
+}
+plasma_config;
+
+/**
+ * \brief Checks whether plasma_config structure doesn't contain errors.
+ * \param config Plasma configuration structure to validate.
+ * \return Zero if config is valid, error code otherwise.
+ *
+ * Error codes that can be returned:
+ * 1. ENOTSUP - flags contain values unknown to this version of plasma;
+ * 2. EINVAL - PLASMA_CONFIG_LATEST combined with PLASMA_CONFIG_OVERWRITE or
+ *    PLASMA_CONFIG_PRIORITY.
+ */
+ionize_status plasma_config_validator( plasma_config const config );
+
+#endif /* PLASMA_CONFIG_H__ */
@@ -0,0 +1,75 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Defines metadata header placed in front of buffer data.
+ * \date        10/19/2026 09:52:06 AM
+ * \file        header.h
+ * \version     1.0
+ *
+ * If the circular queue is configured with PLASMA_CONFIG_HEADER flag, every
+ * buffer reserves its first cache line for plasma_header. Buffer descriptors
+ * returned by lock methods point past the header, so the header doesn't count
+ * into their size. The header is filled by the service when the buffer is
+ * locked for writing and when it's unlocked, clients only read it.
+ **/
+
+#ifndef PLASMA_HEADER_H__
+# define PLASMA_HEADER_H__
+
+# include <stdalign.h> /* alignas */
+# include <stdint.h> /* uint32_t, uint64_t */
+
+/**
+ * \brief Alignment and size of the header, equal to a cache line.
+ */
+# define PLASMA_HEADER_ALIGNMENT 64U
+
+/**
+ * \brief Metadata describing last write to the buffer.
+ * \see ionize_time
+ */
+typedef struct
+{
+    /** Number of the commit, increasing by one in each queue. */
+    alignas( PLASMA_HEADER_ALIGNMENT ) uint64_t sequence;
+    uint64_t timestamp; /** Commit time, as returned by ionize_time. */
+    uint64_t length; /** Number of bytes committed. */
+    uint32_t producer; /** Identifier of the writing client. */
+}
+plasma_header;
+
+/**
+ * \brief Gets header of the buffer.
+ * \param data Buffer data pointer, as returned by one of the lock methods.
+ * \return Pointer to the header of the buffer.
+ * \warning The queue must be configured with PLASMA_CONFIG_HEADER flag.
+ */
+plasma_header const * plasma_header_of( void const * const data );
+
+/**
+ * \brief Fills the header when its buffer gets locked for writing.
+ * \param header Header to fill.
+ * \param producer Identifier of the writing client.
+ *
+ * Commit-related fields are cleared, so readers of a buffer that was never
+ * committed see zero length and sequence.
+ */
+void plasma_header_stamp_lock(
+    plasma_header * const header,
+    uint32_t const producer
+);
+
+/**
+ * \brief Fills the header when its buffer gets committed.
+ * \param header Header to fill.
+ * \param sequence Number of the commit in the queue.
+ * \param length Number of bytes committed.
+ *
+ * Timestamp is taken inside this method.
+ */
+void plasma_header_stamp_commit(
+    plasma_header * const header,
+    uint64_t const sequence,
+    uint64_t const length
+);
+
+#endif /* PLASMA_HEADER_H__ */
@@ -18,10 +18,14 @@
 # define PLASMA_PLASMA_H__
 
 # include <ionize/error.h> /* ionize_status */
+# include <plasma/allocation.h> /* plasma_allocation_flag */
+# include <plasma/config.h> /* plasma_config */
 # include <plasma/properties.h> /* plasma_properties */
+# include <plasma/tag.h> /* plasma_tag */
+# include <plasma/watermark.h> /* plasma_watermark */
 # include <stdbool.h> /* bool */
 # include <stddef.h> /* size_t */
-# include <stdint.h> /* uint32_t */
+# include <stdint.h> /* uint32_t, uint64_t */
 
 /**
  * \brief Forward declaration of the plasma structure.
@@ -33,11 +37,21 @@ typedef struct plasma_struct plasma;
  * \param self Pointer to plasma object on which we'll operate.
  * \param properties Array of buffer properties.
  * \param length Length of sizes array, that many buffer will be allocated.
+ * \param flags Bitwise or of plasma_allocation_flag values.
  * \return Zero on success, else error code.
  * \see plasma_properties
+ * \see plasma_allocation_flag
  *
  * Send a request for allocation to appropriate service. Allocated
- * space is added to the back of circular queue managed by the service.
+ * space is added to the back of circular queue managed by the service,
+ * which can happen while other clients use the queue.
+ * The service may limit memory held by each queue and by each client. An
+ * allocation exceeding either budget fails with EDQUOT and allocates
+ * nothing, so the client can tell it apart from the host running out of
+ * memory (ENOMEM).
+ * Latency-sensitive queues pass PLASMA_ALLOCATION_PREFAULT, and possibly
+ * PLASMA_ALLOCATION_MLOCK, so no write ever takes a page fault; the service
+ * spreads prefaulting over its worker threads.
  * This method blocks until service returns status of the allocation
  * to the client.
  * TODO: error codes.
@@ -45,6 +59,29 @@ typedef struct plasma_struct plasma;
 typedef ionize_status ( * plasma_allocate_func )(
     plasma * const restrict self,
     plasma_properties const * const restrict properties,
+    size_t const length,
+    uint32_t const flags
+);
+
+/**
+ * \brief Requests retirement of memory buffers from the queue.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param length Number of buffers to retire.
+ * \return Zero on success, else error code.
+ * \see plasma_allocate_func
+ *
+ * Together with allocate this allows resizing the queue while it's in use.
+ * Buffers which aren't locked and hold no unread data are retired at once,
+ * with their memory returned to the system. If there are not enough of them,
+ * the remaining buffers are retired as soon as readers consume them. Locks
+ * held by other clients are never broken. This method blocks until service
+ * returns status of the operation to the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. ERANGE - queue has fewer buffers than requested, nothing is retired.
+ */
+typedef ionize_status ( * plasma_shrink_func )(
+    plasma * const self,
     size_t const length
 );
 
@@ -54,7 +91,7 @@ typedef ionize_status ( * plasma_allocate_func )(
 typedef struct
 {
     void const * data; /** Pointer to buffer memory */
-    size_t size; /** Size of buffer memory */
+    size_t size; /** Number of bytes committed by the writer */
 }
 plasma_read_only;
 
@@ -81,7 +118,11 @@ plasma_read;
  * Depending on the blocking behaviour this method will either block
  * until a buffer is available or return with status EAGAIN. Note that
  * the method will always block for the amount of time needed for backend
- * service to communicate with the client.
+ * service to communicate with the client. In queues configured with
+ * PLASMA_CONFIG_PRIORITY the most urgent buffer is returned, as ordered by
+ * tags of buffers. In queues configured with
+ * PLASMA_CONFIG_LATEST the most recently committed buffer is returned,
+ * possibly the same one as before, and it stays readable after unlock.
  * TODO: error codes.
  */
 typedef plasma_read ( * plasma_read_lock_func )(
@@ -89,6 +130,57 @@ typedef plasma_read ( * plasma_read_lock_func )(
     plasma_properties const requested
 );
 
+/**
+ * \brief Locks buffer retained for replay and returns it.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param requested Properties of the buffer we want to acquire.
+ * \param sequence Lowest commit sequence number the caller wants.
+ * \return Structure containing error code and read-only buffer descriptor.
+ * \warning Using the buffer after unlocking it is undefined.
+ * \see plasma_read_lock_func
+ *
+ * Queues may keep recently consumed buffers readable, as set by retention
+ * policy of the service. This lets late-joining or restarting readers catch
+ * up from memory: the method locks retained buffer with lowest sequence
+ * number not less than requested one. Sequence numbers are reported in
+ * plasma_header, so replaying requires PLASMA_CONFIG_HEADER. Replay never
+ * waits and never consumes the buffer; the buffer is released with unlock.
+ * Writers reuse retained buffers only once they run out of free ones, and
+ * skip those being replayed.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. ENOENT - no retained buffer matches, caller should use read_lock;
+ * 3. codes returned by plasma_properties_validator.
+ */
+typedef plasma_read ( * plasma_replay_lock_func )(
+    plasma * const self,
+    plasma_properties const requested,
+    uint64_t const sequence
+);
+
+/**
+ * \brief Locks snapshot of the newest committed data and returns it.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param requested Properties of the buffer we want to acquire.
+ * \return Structure containing error code and read-only buffer descriptor.
+ * \warning Using the buffer after unlocking it is undefined.
+ * \see plasma_read_lock_func
+ *
+ * Meant for slow readers, such as analytical scans, which mustn't hold back
+ * the writers. The buffer isn't consumed and stays intact until unlock:
+ * writers use other buffers meanwhile instead of waiting for the snapshot.
+ * Snapshots never wait; the buffer is released with unlock.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. ENOENT - no buffer in the queue matches requested properties;
+ * 3. EAGAIN - nothing was committed yet;
+ * 4. codes returned by plasma_properties_validator.
+ */
+typedef plasma_read ( * plasma_snapshot_lock_func )(
+    plasma * const self,
+    plasma_properties const requested
+);
+
 /**
  * \brief Representation of writable memory buffer.
  */
@@ -122,7 +214,11 @@ plasma_write;
  * Depending on the blocking behaviour this method will either block
  * until a buffer is available or return with status EAGAIN. Note that
  * the method will always block for the amount of time needed for backend
- * service to communicate with the client.
+ * service to communicate with the client. If readers fall behind and the
+ * unread data exceeds the queue's watermark set in the service, writers
+ * are held back the same way, even if free buffers exist. Queues configured
+ * with PLASMA_CONFIG_OVERWRITE never hold writers back: the oldest readable
+ * buffer no reader has locked is dropped and handed to the writer instead.
  * TODO: error codes.
  */
 typedef plasma_write ( * plasma_write_lock_func )(
@@ -134,13 +230,88 @@ typedef plasma_write ( * plasma_write_lock_func )(
  * \brief Unlocks previously locked buffer.
  * \param self Pointer to plasma object on which we'll operate.
  * \return Zero on success, else error code.
+ * \see plasma_commit_func
  *
  * This method will block for amount of time needed for backend service to
- * communicate with the client.
+ * communicate with the client. Unlocking a buffer locked for writing
+ * commits the whole buffer, as if commit was called with its full size.
+ * Locks held past the queue's lease are revoked by the daemon, unlocking
+ * them fails with ETIMEDOUT.
  * TODO: error codes.
  */
 typedef ionize_status ( * plasma_unlock_func )( plasma * const self );
 
+/**
+ * \brief Unlocks buffer previously locked for writing, committing its data.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param length Number of bytes written, counted from start of the buffer.
+ * \return Zero on success, else error code.
+ * \see plasma_read_only
+ *
+ * Readers locking the buffer afterwards will see length as the size of the
+ * buffer, so they (and anything copying the buffer elsewhere) only have to
+ * touch the bytes actually written. Committing zero bytes is allowed.
+ * This method will block for amount of time needed for backend service to
+ * communicate with the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. EPERM - no buffer is locked for writing by this plasma object;
+ * 3. ERANGE - length is greater than size of the locked buffer;
+ * 4. ETIMEDOUT - the lock was held past the queue's lease and the daemon
+ *    revoked it, the data is discarded.
+ */
+typedef ionize_status ( * plasma_commit_func )(
+    plasma * const self,
+    size_t const length
+);
+
+/**
+ * \brief Tags buffer locked for writing with priority and deadline.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param tag Urgency of the buffer, applied when it's committed.
+ * \return Zero on success, else error code.
+ * \see plasma_tag
+ *
+ * Tags order readers only in queues with PLASMA_CONFIG_PRIORITY, elsewhere
+ * they're ignored. Buffers are untagged when locked for writing. This method
+ * blocks until service returns status of the operation to the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. EPERM - no buffer is locked for writing by this plasma object.
+ */
+typedef ionize_status ( * plasma_tag_func )(
+    plasma * const self,
+    plasma_tag const tag
+);
+
+/**
+ * \brief Reserves bytes in buffer shared with other writers appending.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param length Number of bytes to reserve.
+ * \return Structure containing error code and writable range descriptor.
+ * \warning Using the range after committing it is undefined.
+ * \see plasma_commit_func
+ *
+ * Meant for small records, where locking a whole buffer per record would
+ * waste the buffer and contend on the queue. Writers reserve consecutive
+ * ranges of the same buffer, readers get it once it's full and every range
+ * in it is committed, or once the service flushes it after a timeout. The
+ * range must be committed with commit, passing the whole reserved length.
+ * Appending never waits for buffers, blocking behaviour aside from the time
+ * needed for backend service to communicate with the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given or zero length;
+ * 2. EPERM - a buffer is already locked by this plasma object;
+ * 3. ENOENT - no buffer in the queue can hold length bytes;
+ * 4. ERANGE - length exceeds capacity of the buffer taking appends;
+ * 5. EAGAIN - no free buffer to append to;
+ * 6. ENOMEM - the service has no memory to track the buffer.
+ */
+typedef plasma_write ( * plasma_append_func )(
+    plasma * const self,
+    size_t const length
+);
+
 /**
  * \brief Sets mode of operation for locks.
  * \param self Pointer to plasma object on which we'll operate.
@@ -189,6 +360,132 @@ plasma_uid;
  */
 typedef plasma_uid ( * plasma_uid_func )( plasma * const self );
 
+/**
+ * \brief Configures the circular queue.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param config New configuration of the queue.
+ * \return Zero on success, else error code.
+ * \see plasma_config
+ *
+ * Configuration is a property of the circular queue, so it's shared by all
+ * plasma objects with the same uid. It can be changed only while the queue
+ * has no buffers allocated. This method blocks until service returns status
+ * of the operation to the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. EBUSY - buffers were already allocated in the queue;
+ * 3. codes returned by plasma_config_validator.
+ */
+typedef ionize_status ( * plasma_configure_func )(
+    plasma * const self,
+    plasma_config const config
+);
+
+/**
+ * \brief Representation of type returned by subscribe method.
+ */
+typedef struct
+{
+    ionize_status status; /** Zero on success, else error code. */
+    int fd; /** Pollable descriptor, -1 on error. */
+}
+plasma_subscription;
+
+/**
+ * \brief Subscribes to crossings of queue occupancy watermark.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param watermark Watermark to watch.
+ * \return Structure with error code and pollable descriptor.
+ * \see plasma_watermark
+ * \see plasma_unsubscribe_func
+ *
+ * The returned descriptor behaves like eventfd: it becomes readable each time
+ * the watermark condition starts to hold, and reading 8 bytes from it returns
+ * the number of such crossings since the previous read. If the condition
+ * holds already when subscribing, the descriptor is readable at once. This
+ * method blocks until service returns status of the operation to the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. codes returned by plasma_watermark_validator;
+ * 3. EMFILE, ENFILE, ENOMEM - descriptor couldn't be created.
+ */
+typedef plasma_subscription ( * plasma_subscribe_func )(
+    plasma * const self,
+    plasma_watermark const watermark
+);
+
+/**
+ * \brief Cancels subscription and closes its descriptor.
+ * \param self Pointer to plasma object on which we'll operate.
+ * \param fd Descriptor returned by subscribe method.
+ * \return Zero on success, else error code.
+ *
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given;
+ * 2. ENOENT - fd isn't a subscription of this plasma object.
+ */
+typedef ionize_status ( * plasma_unsubscribe_func )(
+    plasma * const self,
+    int const fd
+);
+
+/**
+ * \brief Moves buffer locked for reading into another queue without copying.
+ * \param self Pointer to plasma object holding the read lock.
+ * \param target Plasma object of the queue receiving the buffer.
+ * \param length Number of bytes readable in target queue.
+ * \return Zero on success, else error code.
+ *
+ * Buffer may be modified in place before the transfer, it becomes committed
+ * readable buffer of the target queue, as if written there and committed with
+ * given length. In exchange, a free buffer of the target queue joins this
+ * queue, so both keep their number of buffers. The read lock is released,
+ * also when the method fails with error other than EINVAL. This method
+ * blocks until service returns status of the operation to the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma object given, source and target are the same or
+ *    only one of them has PLASMA_CONFIG_HEADER;
+ * 2. EPERM - self holds no read lock or shares it with other readers;
+ * 3. ERANGE - length is greater than size of the buffer;
+ * 4. EAGAIN - target queue has no free buffer;
+ * 5. EXDEV - queues aren't served by the same service;
+ * 6. EDQUOT - buffer doesn't fit in target queue's memory quota.
+ */
+typedef ionize_status ( * plasma_transfer_func )(
+    plasma * const self,
+    plasma * const target,
+    size_t const length
+);
+
+/**
+ * \brief Commits written buffer to this and other queues, without copying.
+ * \param self Pointer to plasma object holding the write lock.
+ * \param targets Array of plasma objects of queues receiving the buffer.
+ * \param count Length of targets array.
+ * \param length Number of bytes written.
+ * \return Zero on success, else error code.
+ * \see plasma_commit_func
+ *
+ * Works like commit, but the buffer also becomes committed buffer of every
+ * target queue. Queues share the memory: it's reused only after readers of
+ * all of them consumed the buffer. The write lock is released, even if some
+ * targets failed to receive the buffer. This method blocks until service
+ * returns status of the operation to the client.
+ * Possible error codes:
+ * 1. EINVAL - invalid plasma objects given, self is among targets or only
+ *    some of the queues have PLASMA_CONFIG_HEADER;
+ * 2. EPERM - self holds no write lock;
+ * 3. ERANGE - length is greater than size of the buffer;
+ * 4. EXDEV - queues aren't served by the same service;
+ * 5. ENOMEM - service couldn't allocate memory for bookkeeping.
+ */
+typedef ionize_status ( * plasma_publish_func )(
+    plasma * const self,
+    plasma * const * const targets,
+    size_t const count,
+    size_t const length
+);
+
 /**
  * \brief Opaque type holding internal plasma state.
  */
@@ -201,8 +498,19 @@ typedef struct plasma_state_struct plasma_state;
  * \see plasma_read_lock_func
  * \see plasma_write_lock_func
  * \see plasma_unlock_func
+ * \see plasma_commit_func
  * \see plasma_blocking_func
  * \see plasma_uid_func
+ * \see plasma_configure_func
+ * \see plasma_shrink_func
+ * \see plasma_subscribe_func
+ * \see plasma_unsubscribe_func
+ * \see plasma_replay_lock_func
+ * \see plasma_transfer_func
+ * \see plasma_publish_func
+ * \see plasma_snapshot_lock_func
+ * \see plasma_tag_func
+ * \see plasma_append_func
  */
 struct plasma_struct
 {
@@ -213,6 +521,17 @@ struct plasma_struct
     plasma_unlock_func unlock;
     plasma_blocking_func blocking;
     plasma_uid_func uid;
+    plasma_commit_func commit;
+    plasma_configure_func configure;
+    plasma_shrink_func shrink;
+    plasma_subscribe_func subscribe;
+    plasma_unsubscribe_func unsubscribe;
+    plasma_replay_lock_func replay_lock;
+    plasma_transfer_func transfer;
+    plasma_publish_func publish;
+    plasma_snapshot_lock_func snapshot_lock;
+    plasma_tag_func tag;
+    plasma_append_func append;
 };
 
 #endif /* PLASMA_PLASMA_H__ */
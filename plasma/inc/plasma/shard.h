@@ -0,0 +1,42 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Mapping of queues onto shards of the service.
+ * \date        10/21/2026 03:12:40 PM
+ * \file        shard.h
+ * \version     1.0
+ *
+ * The service runs as several shards, each one a single thread pinned to a
+ * core and listening on a port of its own. Every queue is owned by exactly
+ * one shard, chosen by hashing its uid, so shards never share queue state
+ * and no lock is taken across them. Clients compute the owning shard with
+ * the same function and connect straight to it.
+ **/
+
+#ifndef PLASMA_SHARD_H__
+# define PLASMA_SHARD_H__
+
+# include <stdint.h> /* uint16_t, uint32_t */
+
+/**
+ * \brief Returns shard owning the queue.
+ * \param uid Unique identifier of the queue.
+ * \param shards Number of shards the service runs.
+ * \return Index of the shard, lower than shards, zero if shards is zero.
+ *
+ * Consecutive uids are spread evenly, the mapping only changes when the
+ * number of shards does.
+ */
+uint32_t plasma_shard( uint32_t const uid, uint32_t const shards );
+
+/**
+ * \brief Returns port of the shard owning the queue.
+ * \param uid Unique identifier of the queue.
+ * \param shards Number of shards the service runs.
+ * \return Port the owning shard listens on.
+ * \see ionize_port
+ *
+ * Shards listen on consecutive ports, the first one on ionize_port.
+ */
+uint16_t plasma_shard_port( uint32_t const uid, uint32_t const shards );
+
+#endif /* PLASMA_SHARD_H__ */
@@ -0,0 +1,34 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Defines priority and deadline tags of buffers.
+ * \date        10/21/2026 10:14:06 AM
+ * \file        tag.h
+ * \version     1.0
+ *
+ * Writers may tag buffers before committing them. Queues configured with
+ * PLASMA_CONFIG_PRIORITY hand readers the most urgent readable buffer instead
+ * of the oldest one, so urgent traffic doesn't queue behind bulk data.
+ **/
+
+#ifndef PLASMA_TAG_H__
+# define PLASMA_TAG_H__
+
+# include <stdint.h> /* uint32_t, uint64_t */
+
+/**
+ * \brief Urgency of a buffer.
+ *
+ * Buffers with higher priority are read first. Among buffers of equal
+ * priority, the one with earlier deadline goes first, and buffers without
+ * deadline go last. Remaining ties are broken by commit order. Deadline is
+ * absolute time in nanoseconds, as returned by ionize_time. Zero-initialized
+ * tag describes untagged buffer.
+ */
+typedef struct
+{
+    uint32_t priority; /** Higher is more urgent. */
+    uint64_t deadline; /** Absolute time in ns, zero for none. */
+}
+plasma_tag;
+
+#endif /* PLASMA_TAG_H__ */
@@ -0,0 +1,65 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Defines queue occupancy watermarks.
+ * \date        10/20/2026 02:48:31 PM
+ * \file        watermark.h
+ * \version     1.0
+ *
+ * Clients may subscribe to crossings of queue occupancy watermarks instead
+ * of polling locks. Producers can throttle before they start getting EAGAIN
+ * and consumers can scale out when readable buffers pile up.
+ **/
+
+#ifndef PLASMA_WATERMARK_H__
+# define PLASMA_WATERMARK_H__
+
+# include <ionize/error.h> /* ionize_status */
+# include <stdint.h> /* uint32_t */
+
+/**
+ * \brief Conditions a watermark can describe.
+ */
+typedef enum
+{
+    PLASMA_WATERMARK_WRITABLE_BELOW, /** Fewer free buffers than threshold. */
+    PLASMA_WATERMARK_READABLE_ABOVE /** More readable buffers than threshold. */
+}
+plasma_watermark_kind;
+
+/**
+ * \brief Units of watermark threshold.
+ */
+typedef enum
+{
+    PLASMA_WATERMARK_BUFFERS, /** Number of buffers. */
+    PLASMA_WATERMARK_PERCENT /** Percent of all buffers in the queue. */
+}
+plasma_watermark_unit;
+
+/**
+ * \brief Queue occupancy watermark.
+ *
+ * For example, watermark with kind PLASMA_WATERMARK_WRITABLE_BELOW, threshold
+ * 10 and unit PLASMA_WATERMARK_PERCENT describes queue with fewer than 10%
+ * of its buffers free for writing.
+ */
+typedef struct
+{
+    plasma_watermark_kind kind; /** Condition of the watermark. */
+    uint32_t threshold; /** Threshold of the condition. */
+    plasma_watermark_unit unit; /** Unit of the threshold. */
+}
+plasma_watermark;
+
+/**
+ * \brief Checks whether plasma_watermark structure doesn't contain errors.
+ * \param watermark Watermark to validate.
+ * \return Zero if watermark is valid, error code otherwise.
+ *
+ * Error codes that can be returned:
+ * 1. EINVAL - unknown kind or unit;
+ * 2. ERANGE - threshold in percent is greater than 100.
+ */
+ionize_status plasma_watermark_validator( plasma_watermark const watermark );
+
+#endif /* PLASMA_WATERMARK_H__ */
@@ -0,0 +1,20 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of helper methods for allocation flags.
+ * \date        10/24/2026 09:12:19 AM
+ * \file        allocation.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* ENOTSUP */
+#include <ionize/error.h> /* ionize_status */
+#include <plasma/allocation.h> /* PLASMA_ALLOCATION_FLAGS */
+#include <stdint.h> /* uint32_t */
+
+ionize_status plasma_allocation_validator( uint32_t const flags )
+{
+    /* only known flags may be set, all of them combine */
+    return ( 0U != ( flags & ~PLASMA_ALLOCATION_FLAGS )) ? ENOTSUP : 0;
+}
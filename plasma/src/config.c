@@ -0,0 +1,33 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of helper methods for plasma_config.
+ * \date        10/19/2026 09:40:52 AM
+ * \file        config.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* EINVAL, ENOTSUP */
+#include <ionize/error.h> /* ionize_status */
+#include <plasma/config.h> /* plasma_config */
+
+ionize_status plasma_config_validator( plasma_config const config )
+{
+    /* only known flags may be set */
+    if( 0U != ( config.flags & ~PLASMA_CONFIG_FLAGS ))
+    {
+        return ENOTSUP;
+    }
+    /* latest-value queue has single readable buffer, nothing to reorder */
+    uint32_t const ordering = PLASMA_CONFIG_OVERWRITE | PLASMA_CONFIG_PRIORITY;
+    if(
+        ( 0U != ( config.flags & PLASMA_CONFIG_LATEST ))
+        && ( 0U != ( config.flags & ordering ))
+    )
+    {
+        return EINVAL;
+    }
+    /* config is valid */
+    return 0;
+}
@@ -0,0 +1,41 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of buffer header helpers.
+ * \date        10/19/2026 10:04:44 AM
+ * \file        header.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <ionize/time.h> /* ionize_time */
+#include <plasma/header.h>
+#include <stdint.h> /* uint8_t, uint32_t, uint64_t */
+
+plasma_header const * plasma_header_of( void const * const data )
+{
+    return ( plasma_header const * )
+        (( uint8_t const * ) data - sizeof( plasma_header ));
+}
+
+void plasma_header_stamp_lock(
+    plasma_header * const header,
+    uint32_t const producer
+)
+{
+    header->sequence = 0U;
+    header->timestamp = 0U;
+    header->length = 0U;
+    header->producer = producer;
+}
+
+void plasma_header_stamp_commit(
+    plasma_header * const header,
+    uint64_t const sequence,
+    uint64_t const length
+)
+{
+    header->length = length;
+    header->timestamp = ionize_time();
+    header->sequence = sequence;
+}
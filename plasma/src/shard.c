@@ -0,0 +1,26 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of shard mapping.
+ * \date        10/21/2026 03:20:18 PM
+ * \file        shard.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <ionize/universal.h> /* ionize_port */
+#include <plasma/shard.h>
+#include <stdint.h> /* uint16_t, uint32_t, uint64_t */
+
+uint32_t plasma_shard( uint32_t const uid, uint32_t const shards )
+{
+    /* Fibonacci hashing scatters sequential uids over the whole range */
+    uint32_t const hash = uid * UINT32_C( 2654435769 );
+    /* scaling instead of modulo keeps it uniform for any shard count */
+    return ( uint32_t ) ((( uint64_t ) hash * shards ) >> 32 );
+}
+
+uint16_t plasma_shard_port( uint32_t const uid, uint32_t const shards )
+{
+    return ( uint16_t ) ( ionize_port() + plasma_shard( uid, shards ));
+}
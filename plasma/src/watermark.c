@@ -0,0 +1,45 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definitions of helper methods for plasma_watermark.
+ * \date        10/20/2026 03:02:17 PM
+ * \file        watermark.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <errno.h> /* EINVAL, ERANGE */
+#include <ionize/error.h> /* ionize_status */
+#include <plasma/watermark.h> /* plasma_watermark */
+
+#define PERCENT_MAXIMUM 100U
+
+ionize_status plasma_watermark_validator( plasma_watermark const watermark )
+{
+    /* kind must be known */
+    if(
+        ( PLASMA_WATERMARK_WRITABLE_BELOW != watermark.kind )
+        && ( PLASMA_WATERMARK_READABLE_ABOVE != watermark.kind )
+    )
+    {
+        return EINVAL;
+    }
+    /* unit must be known */
+    if(
+        ( PLASMA_WATERMARK_BUFFERS != watermark.unit )
+        && ( PLASMA_WATERMARK_PERCENT != watermark.unit )
+    )
+    {
+        return EINVAL;
+    }
+    /* percents can't exceed the whole */
+    if(
+        ( PLASMA_WATERMARK_PERCENT == watermark.unit )
+        && ( PERCENT_MAXIMUM < watermark.threshold )
+    )
+    {
+        return ERANGE;
+    }
+    /* watermark is valid */
+    return 0;
+}
@@ -18,11 +18,14 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #define BUFSIZE 10
 #define EDUMMY (( int ) 0xC0FFEEEE)
 
 static uint8_t buf[ BUFSIZE ]; /* inited to zeroes */
+static size_t committed = BUFSIZE; /* bytes committed by last writer */
 static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -44,7 +47,8 @@ struct plasma_state_struct
 static ionize_status allocate(
     plasma * const restrict self,
     plasma_properties const * const restrict properties,
-    size_t const length
+    size_t const length,
+    uint32_t const flags
 )
 {
     if(
@@ -59,7 +63,152 @@ static ionize_status allocate(
     {
         return EINVAL;
     }
-    return 0;
+    return plasma_allocation_validator( flags );
+}
+
+static ionize_status configure(
+    plasma * const self,
+    plasma_config const config
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    return plasma_config_validator( config );
+}
+
+static ionize_status shrink( plasma * const self, size_t const length )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    /* mock queue has exactly one buffer, which it never really retires */
+    return ( 1U < length ) ? ERANGE : 0;
+}
+
+/* mock queue never changes occupancy, so descriptor is never signalled */
+static plasma_subscription subscribe(
+    plasma * const self,
+    plasma_watermark const watermark
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_subscription ) { EINVAL, -1 };
+    }
+    ionize_status const result = plasma_watermark_validator( watermark );
+    if( 0 != result )
+    {
+        return ( plasma_subscription ) { result, -1 };
+    }
+    int const fd = eventfd( 0U, 0 );
+    return ( plasma_subscription ) { ( -1 == fd ) ? errno : 0, fd };
+}
+
+static ionize_status unsubscribe( plasma * const self, int const fd )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    return ( 0 == close( fd )) ? 0 : ENOENT;
+}
+
+/* mock queue has a single buffer and retains nothing for replay */
+static plasma_read replay_lock(
+    plasma * const self,
+    plasma_properties const requested,
+    uint64_t const sequence
+)
+{
+    UNUSED( sequence );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_read ) { EINVAL, { NULL, 0 } };
+    }
+    ionize_status const result = plasma_properties_validator( requested );
+    return ( plasma_read ) { ( 0 == result ) ? ENOENT : result, { NULL, 0 } };
+}
+
+/* mock queues aren't served by one daemon, nothing can be moved */
+static ionize_status transfer(
+    plasma * const self,
+    plasma * const target,
+    size_t const length
+)
+{
+    UNUSED( length );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( NULL == target )
+        || ( NULL == target->state )
+        || ( self == target )
+    )
+    {
+        return EINVAL;
+    }
+    return ( READER == self->state->current ) ? EXDEV : EPERM;
+}
+
+static ionize_status publish(
+    plasma * const self,
+    plasma * const * const targets,
+    size_t const count,
+    size_t const length
+)
+{
+    UNUSED( length );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( NULL == targets )
+    )
+    {
+        return EINVAL;
+    }
+    for( size_t i = 0U; i < count; ++i )
+    {
+        if(( NULL == targets[ i ] ) || ( self == targets[ i ] ))
+        {
+            return EINVAL;
+        }
+    }
+    return ( WRITER == self->state->current ) ? EXDEV : EPERM;
+}
+
+/* mock queue can't keep a snapshot apart from its single buffer */
+static plasma_read snapshot_lock(
+    plasma * const self,
+    plasma_properties const requested
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_read ) { EINVAL, { NULL, 0 } };
+    }
+    ionize_status const result = plasma_properties_validator( requested );
+    return ( plasma_read ) { ( 0 == result ) ? EAGAIN : result, { NULL, 0 } };
 }
 
 static plasma_read rlock(
@@ -161,7 +310,7 @@ static ionize_status blocking( plasma * const self, bool const state )
     return 0;
 }
 
-static ionize_status unlock( plasma * const self )
+static ionize_status release( plasma * const self, size_t const length )
 {
     if(
         ( NULL == self )
@@ -174,6 +323,10 @@ static ionize_status unlock( plasma * const self )
     int const result = pthread_rwlock_unlock( &rwlock );
     if( 0 == result )
     {
+        if( WRITER == self->state->current )
+        {
+            committed = length;
+        }
         --( self->state->inside_critical_section );
         if( 0U == self->state->inside_critical_section )
         {
@@ -195,6 +348,66 @@ static ionize_status unlock( plasma * const self )
     return result;
 }
 
+static ionize_status unlock( plasma * const self )
+{
+    return release( self, BUFSIZE );
+}
+
+static ionize_status commit( plasma * const self, size_t const length )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    UNUSED( pthread_mutex_lock( &mutex ));
+    owner const current = self->state->current;
+    UNUSED( pthread_mutex_unlock( &mutex ));
+    if( WRITER != current )
+    {
+        return EPERM;
+    }
+    if( BUFSIZE < length )
+    {
+        return ERANGE;
+    }
+    return release( self, length );
+}
+
+static ionize_status tag( plasma * const self, plasma_tag const tag )
+{
+    UNUSED( tag );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    UNUSED( pthread_mutex_lock( &mutex ));
+    owner const current = self->state->current;
+    UNUSED( pthread_mutex_unlock( &mutex ));
+    return ( WRITER == current ) ? 0 : EPERM;
+}
+
+static plasma_write append( plasma * const self, size_t const length )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_write ) { EINVAL, { NULL, 0 } };
+    }
+    if(( 0U == length ) || ( BUFSIZE < length ))
+    {
+        return ( plasma_write ) { ERANGE, { NULL, 0 } };
+    }
+    return ( plasma_write ) { EAGAIN, { NULL, 0 } };
+}
+
 static plasma_read tryrlock(
     plasma * const self,
     plasma_properties const requested
@@ -234,7 +447,7 @@ static plasma_read tryrlock(
         self->write_lock = dummy_wlock;
     }
     UNUSED( pthread_mutex_unlock( &mutex ));
-    return ( plasma_read ) { 0, { buf, BUFSIZE } };
+    return ( plasma_read ) { 0, { buf, committed } };
 }
 
 static plasma_read rlock(
@@ -276,7 +489,7 @@ static plasma_read rlock(
         self->write_lock = dummy_wlock;
     }
     UNUSED( pthread_mutex_unlock( &mutex ));
-    return ( plasma_read ) { 0, { buf, BUFSIZE } };
+    return ( plasma_read ) { 0, { buf, committed } };
 }
 
 static plasma_write trywlock(
@@ -381,11 +594,35 @@ int main( int argc, char ** args )
     UNUSED( args );
 
     plasma_state state = { true, 0, NONE };
-    plasma p = { &state, allocate, rlock, wlock, dummy_unlock, blocking, uid };
+    plasma p =
+    {
+        &state,
+        allocate,
+        rlock,
+        wlock,
+        dummy_unlock,
+        blocking,
+        uid,
+        commit,
+        configure,
+        shrink,
+        subscribe,
+        unsubscribe,
+        replay_lock,
+        transfer,
+        publish,
+        snapshot_lock,
+        tag,
+        append
+    };
 
     plasma_properties const invalid = { 0U, 0U, 0U };
     plasma_properties const valid = { BUFSIZE, BUFSIZE, 1U };
 
+    assert( EINVAL == p.configure( NULL, ( plasma_config ) { 0U } ));
+    assert( ENOTSUP == p.configure( &p, ( plasma_config ) { UINT32_MAX } ));
+    assert( 0 == p.configure( &p, ( plasma_config ) { PLASMA_CONFIG_HEADER } ));
+
     assert( 0 == p.blocking( &p, false ));
     assert( 0 == p.write_lock( &p, valid ).status );
     assert( EINVAL == p.read_lock( &p, invalid ).status );
@@ -396,17 +633,68 @@ int main( int argc, char ** args )
     assert( EINVAL == p.unlock( &p ));
     assert( 0 == p.write_lock( &p, valid ).status );
     assert( EBUSY == p.write_lock( &p, valid ).status );
+    assert( 0 == p.tag( &p, ( plasma_tag ) { 1U, 0U } ));
     assert( 0 == p.unlock( &p ));
 
     assert( EINVAL == p.allocate( &p, ( plasma_properties[] ) {
                 { 2U, 3U, 4U },
                 { BUFSIZE, BUFSIZE - 1, 0U }
-    }, 2U ));
-    assert( EINVAL == p.allocate( NULL, NULL, 0U ));
+    }, 2U, 0U ));
+    assert( EINVAL == p.allocate( NULL, NULL, 0U, 0U ));
     assert( EINVAL == p.allocate( &p,
-                ( plasma_properties[] ) { { 1U, 1U, 1U } }, 1U ));
+                ( plasma_properties[] ) { { 1U, 1U, 1U } }, 1U, 0U ));
     assert( 0 == p.allocate( &p,
-                ( plasma_properties[] ) { { BUFSIZE, BUFSIZE, 1U } }, 1U ));
+                ( plasma_properties[] ) { { BUFSIZE, BUFSIZE, 1U } }, 1U, 0U ));
+    assert( 0 == p.allocate(
+                &p,
+                ( plasma_properties[] ) { { BUFSIZE, BUFSIZE, 1U } },
+                1U,
+                PLASMA_ALLOCATION_PREFAULT | PLASMA_ALLOCATION_MLOCK
+    ));
+    assert( ENOTSUP == p.allocate(
+                &p,
+                ( plasma_properties[] ) { { BUFSIZE, BUFSIZE, 1U } },
+                1U,
+                ~PLASMA_ALLOCATION_FLAGS
+    ));
+    plasma_watermark const low = {
+        PLASMA_WATERMARK_WRITABLE_BELOW,
+        10U,
+        PLASMA_WATERMARK_PERCENT
+    };
+    plasma_subscription subscription;
+    assert( EINVAL == p.subscribe( NULL, low ).status );
+    assert( ERANGE == p.subscribe( &p, ( plasma_watermark ) {
+                PLASMA_WATERMARK_READABLE_ABOVE,
+                101U,
+                PLASMA_WATERMARK_PERCENT
+    } ).status );
+    assert( 0 == ( subscription = p.subscribe( &p, low )).status );
+    assert( -1 != subscription.fd );
+    assert( 0 == p.unsubscribe( &p, subscription.fd ));
+    assert( ENOENT == p.unsubscribe( &p, subscription.fd ));
+
+    assert( EINVAL == p.replay_lock( NULL, valid, 0U ).status );
+    assert( ENOENT == p.replay_lock( &p, valid, 0U ).status );
+    assert( EINVAL == p.replay_lock( &p, invalid, 0U ).status );
+
+    assert( EINVAL == p.transfer( &p, NULL, 0U ));
+    assert( EINVAL == p.transfer( &p, &p, 0U ));
+    plasma * const self[] = { &p };
+    assert( EINVAL == p.publish( &p, self, 1U, 0U ));
+    assert( EPERM == p.publish( &p, self, 0U, 0U ));
+    assert( EINVAL == p.snapshot_lock( NULL, valid ).status );
+    assert( EAGAIN == p.snapshot_lock( &p, valid ).status );
+    assert( EINVAL == p.tag( NULL, ( plasma_tag ) { 1U, 0U } ));
+    assert( EPERM == p.tag( &p, ( plasma_tag ) { 1U, 0U } ));
+    assert( EINVAL == p.append( NULL, 1U ).status );
+    assert( ERANGE == p.append( &p, 0U ).status );
+    assert( ERANGE == p.append( &p, BUFSIZE + 1U ).status );
+    assert( EAGAIN == p.append( &p, 1U ).status );
+
+    assert( EINVAL == p.shrink( NULL, 1U ));
+    assert( ERANGE == p.shrink( &p, 2U ));
+    assert( 0 == p.shrink( &p, 0U ));
 
     assert( EINVAL == p.unlock( &p ));
     assert( dummy_unlock == p.unlock );
@@ -486,6 +774,28 @@ int main( int argc, char ** args )
 
     assert( dummy_unlock == p.unlock );
 
+    /* committing needs a write lock and can't exceed buffer size */
+    assert( EINVAL == p.commit( NULL, 0U ));
+    assert( EPERM == p.commit( &p, 1U ));
+    assert( 0 == p.read_lock( &p, valid ).status );
+    assert( EPERM == p.commit( &p, 1U ));
+    assert( 0 == p.unlock( &p ));
+    assert( 0 == ( wr = p.write_lock( &p, valid )).status );
+    assert( ERANGE == p.commit( &p, BUFSIZE + 1U ));
+    (( char * )( wr.buf.data ))[ 0 ] = 23;
+    assert( 0 == p.commit( &p, 1U ));
+    assert( dummy_unlock == p.unlock );
+    assert( 0 == ( rr = p.read_lock( &p, valid )).status );
+    assert( 1U == rr.buf.size );
+    assert( 23 == (( char const * )( rr.buf.data ))[ 0 ] );
+    assert( 0 == p.unlock( &p ));
+    /* plain unlock after write commits the whole buffer */
+    assert( 0 == p.write_lock( &p, valid ).status );
+    assert( 0 == p.unlock( &p ));
+    assert( 0 == ( rr = p.read_lock( &p, valid )).status );
+    assert( BUFSIZE == rr.buf.size );
+    assert( 0 == p.unlock( &p ));
+
     return 0;
 }
 
@@ -21,6 +21,8 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -28,6 +30,7 @@
 #define EDUMMY (( int ) 0xC0FFEEEE )
 
 static uint8_t buf[ BUFSIZE ]; /* inited to zeroes */
+static size_t committed = BUFSIZE; /* bytes committed by last writer */
 static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -49,7 +52,8 @@ struct plasma_state_struct
 static ionize_status allocate(
     plasma * const restrict self,
     plasma_properties const * const restrict properties,
-    size_t const length
+    size_t const length,
+    uint32_t const flags
 )
 {
     if(
@@ -64,7 +68,152 @@ static ionize_status allocate(
     {
         return EINVAL;
     }
-    return 0;
+    return plasma_allocation_validator( flags );
+}
+
+static ionize_status configure(
+    plasma * const self,
+    plasma_config const config
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    return plasma_config_validator( config );
+}
+
+static ionize_status shrink( plasma * const self, size_t const length )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    /* mock queue has exactly one buffer, which it never really retires */
+    return ( 1U < length ) ? ERANGE : 0;
+}
+
+/* mock queue never changes occupancy, so descriptor is never signalled */
+static plasma_subscription subscribe(
+    plasma * const self,
+    plasma_watermark const watermark
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_subscription ) { EINVAL, -1 };
+    }
+    ionize_status const result = plasma_watermark_validator( watermark );
+    if( 0 != result )
+    {
+        return ( plasma_subscription ) { result, -1 };
+    }
+    int const fd = eventfd( 0U, 0 );
+    return ( plasma_subscription ) { ( -1 == fd ) ? errno : 0, fd };
+}
+
+static ionize_status unsubscribe( plasma * const self, int const fd )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    return ( 0 == close( fd )) ? 0 : ENOENT;
+}
+
+/* mock queue has a single buffer and retains nothing for replay */
+static plasma_read replay_lock(
+    plasma * const self,
+    plasma_properties const requested,
+    uint64_t const sequence
+)
+{
+    UNUSED( sequence );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_read ) { EINVAL, { NULL, 0 } };
+    }
+    ionize_status const result = plasma_properties_validator( requested );
+    return ( plasma_read ) { ( 0 == result ) ? ENOENT : result, { NULL, 0 } };
+}
+
+/* mock queues aren't served by one daemon, nothing can be moved */
+static ionize_status transfer(
+    plasma * const self,
+    plasma * const target,
+    size_t const length
+)
+{
+    UNUSED( length );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( NULL == target )
+        || ( NULL == target->state )
+        || ( self == target )
+    )
+    {
+        return EINVAL;
+    }
+    return ( READER == self->state->current ) ? EXDEV : EPERM;
+}
+
+static ionize_status publish(
+    plasma * const self,
+    plasma * const * const targets,
+    size_t const count,
+    size_t const length
+)
+{
+    UNUSED( length );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+        || ( NULL == targets )
+    )
+    {
+        return EINVAL;
+    }
+    for( size_t i = 0U; i < count; ++i )
+    {
+        if(( NULL == targets[ i ] ) || ( self == targets[ i ] ))
+        {
+            return EINVAL;
+        }
+    }
+    return ( WRITER == self->state->current ) ? EXDEV : EPERM;
+}
+
+/* mock queue can't keep a snapshot apart from its single buffer */
+static plasma_read snapshot_lock(
+    plasma * const self,
+    plasma_properties const requested
+)
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_read ) { EINVAL, { NULL, 0 } };
+    }
+    ionize_status const result = plasma_properties_validator( requested );
+    return ( plasma_read ) { ( 0 == result ) ? EAGAIN : result, { NULL, 0 } };
 }
 
 static plasma_read rlock(
@@ -166,7 +315,7 @@ static ionize_status blocking( plasma * const self, bool const state )
     return 0;
 }
 
-static ionize_status unlock( plasma * const self )
+static ionize_status release( plasma * const self, size_t const length )
 {
     if(
         ( NULL == self )
@@ -179,6 +328,10 @@ static ionize_status unlock( plasma * const self )
     int const result = pthread_rwlock_unlock( &rwlock );
     if( 0 == result )
     {
+        if( WRITER == self->state->current )
+        {
+            committed = length;
+        }
         --( self->state->inside_critical_section );
         if( 0U == self->state->inside_critical_section )
         {
@@ -200,6 +353,66 @@ static ionize_status unlock( plasma * const self )
     return result;
 }
 
+static ionize_status unlock( plasma * const self )
+{
+    return release( self, BUFSIZE );
+}
+
+static ionize_status commit( plasma * const self, size_t const length )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    UNUSED( pthread_mutex_lock( &mutex ));
+    owner const current = self->state->current;
+    UNUSED( pthread_mutex_unlock( &mutex ));
+    if( WRITER != current )
+    {
+        return EPERM;
+    }
+    if( BUFSIZE < length )
+    {
+        return ERANGE;
+    }
+    return release( self, length );
+}
+
+static ionize_status tag( plasma * const self, plasma_tag const tag )
+{
+    UNUSED( tag );
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return EINVAL;
+    }
+    UNUSED( pthread_mutex_lock( &mutex ));
+    owner const current = self->state->current;
+    UNUSED( pthread_mutex_unlock( &mutex ));
+    return ( WRITER == current ) ? 0 : EPERM;
+}
+
+static plasma_write append( plasma * const self, size_t const length )
+{
+    if(
+        ( NULL == self )
+        || ( NULL == self->state )
+    )
+    {
+        return ( plasma_write ) { EINVAL, { NULL, 0 } };
+    }
+    if(( 0U == length ) || ( BUFSIZE < length ))
+    {
+        return ( plasma_write ) { ERANGE, { NULL, 0 } };
+    }
+    return ( plasma_write ) { EAGAIN, { NULL, 0 } };
+}
+
 static plasma_read tryrlock(
     plasma * const self,
     plasma_properties const requested
@@ -239,7 +452,7 @@ static plasma_read tryrlock(
         self->write_lock = dummy_wlock;
     }
     UNUSED( pthread_mutex_unlock( &mutex ));
-    return ( plasma_read ) { 0, { buf, BUFSIZE } };
+    return ( plasma_read ) { 0, { buf, committed } };
 }
 
 static plasma_read rlock(
@@ -281,7 +494,7 @@ static plasma_read rlock(
         self->write_lock = dummy_wlock;
     }
     UNUSED( pthread_mutex_unlock( &mutex ));
-    return ( plasma_read ) { 0, { buf, BUFSIZE } };
+    return ( plasma_read ) { 0, { buf, committed } };
 }
 
 static plasma_write trywlock(
@@ -397,7 +610,7 @@ ionize_status autotest_allocate( void )
             plasma_properties const random = { a, b, c };
             ionize_status const result =
                 pp->allocate( pp,
-                        ( plasma_properties const [] ) { random }, d );
+                        ( plasma_properties const [] ) { random }, d, 0U );
             printf(
                 "[%s false (%lu, %lu, %lu, %lu)] status = %d\n",
                 __func__,
@@ -413,7 +626,12 @@ ionize_status autotest_allocate( void )
         {
             plasma_properties const ok = { BUFSIZE, BUFSIZE, 1U };
             ionize_status const result = 
-                pp->allocate( pp, ( plasma_properties const[] ) { ok }, 1U );
+                pp->allocate(
+                        pp,
+                        ( plasma_properties const[] ) { ok },
+                        1U,
+                        PLASMA_ALLOCATION_PREFAULT
+                );
             printf(
                 "[%s true] status = %d\n",
                 __func__,
@@ -591,7 +809,27 @@ int main( int argc, char ** args )
     UNUSED( args );
 
     plasma_state state = { true, 0, NONE };
-    plasma p = { &state, allocate, rlock, wlock, dummy_unlock, blocking, uid };
+    plasma p =
+    {
+        &state,
+        allocate,
+        rlock,
+        wlock,
+        dummy_unlock,
+        blocking,
+        uid,
+        commit,
+        configure,
+        shrink,
+        subscribe,
+        unsubscribe,
+        replay_lock,
+        transfer,
+        publish,
+        snapshot_lock,
+        tag,
+        append
+    };
 
     pp = &p;
 
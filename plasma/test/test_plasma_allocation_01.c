@@ -0,0 +1,32 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests plasma_allocation_validator.
+ * \date        10/24/2026 09:20:33 AM
+ * \file        test_plasma_allocation_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/error.h>
+#include <ionize/universal.h>
+#include <plasma/allocation.h>
+#include <stdint.h>
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( 0 == plasma_allocation_validator( 0U ));
+    assert( 0 == plasma_allocation_validator( PLASMA_ALLOCATION_PREFAULT ));
+    assert( 0 == plasma_allocation_validator( PLASMA_ALLOCATION_MLOCK ));
+    assert( 0 == plasma_allocation_validator( PLASMA_ALLOCATION_FLAGS ));
+    assert( ENOTSUP == plasma_allocation_validator(
+                ~PLASMA_ALLOCATION_FLAGS ));
+    assert( ENOTSUP == plasma_allocation_validator( UINT32_MAX ));
+
+    return 0;
+}
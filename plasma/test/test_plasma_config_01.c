@@ -0,0 +1,45 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests plasma_config_validator.
+ * \date        10/19/2026 10:21:09 AM
+ * \file        test_plasma_config_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/error.h>
+#include <ionize/universal.h>
+#include <plasma/config.h>
+#include <stdint.h>
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( 0 == plasma_config_validator( ( plasma_config ) { 0U } ));
+    assert( 0 == plasma_config_validator(
+                ( plasma_config ) { PLASMA_CONFIG_HEADER } ));
+    assert( 0 == plasma_config_validator(
+                ( plasma_config ) { PLASMA_CONFIG_OVERWRITE } ));
+    assert( 0 == plasma_config_validator( ( plasma_config ) {
+                PLASMA_CONFIG_HEADER | PLASMA_CONFIG_LATEST
+    } ));
+    assert( 0 == plasma_config_validator( ( plasma_config ) {
+                PLASMA_CONFIG_OVERWRITE | PLASMA_CONFIG_PRIORITY
+    } ));
+    assert( EINVAL == plasma_config_validator( ( plasma_config ) {
+                PLASMA_CONFIG_LATEST | PLASMA_CONFIG_PRIORITY
+    } ));
+    assert( EINVAL == plasma_config_validator(
+                ( plasma_config ) { PLASMA_CONFIG_FLAGS } ));
+    assert( ENOTSUP == plasma_config_validator(
+                ( plasma_config ) { ~PLASMA_CONFIG_FLAGS } ));
+    assert( ENOTSUP == plasma_config_validator(
+                ( plasma_config ) { UINT32_MAX } ));
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests plasma_header helpers.
+ * \date        10/19/2026 10:27:48 AM
+ * \file        test_plasma_header_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <ionize/universal.h>
+#include <plasma/header.h>
+#include <stdalign.h>
+#include <stdint.h>
+
+#define BUFSIZE 10
+
+/* layout used by the service: header followed by buffer data */
+typedef struct
+{
+    plasma_header header;
+    uint8_t data[ BUFSIZE ];
+}
+buffer;
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( PLASMA_HEADER_ALIGNMENT == sizeof( plasma_header ));
+    assert( PLASMA_HEADER_ALIGNMENT == alignof( plasma_header ));
+
+    buffer b;
+    plasma_header_stamp_lock( &( b.header ), 42U );
+    assert( &( b.header ) == plasma_header_of( b.data ));
+    assert( 42U == plasma_header_of( b.data )->producer );
+    assert( 0U == plasma_header_of( b.data )->sequence );
+    assert( 0U == plasma_header_of( b.data )->length );
+
+    plasma_header_stamp_commit( &( b.header ), 1U, BUFSIZE );
+    plasma_header const * const header = plasma_header_of( b.data );
+    assert( 1U == header->sequence );
+    assert( BUFSIZE == header->length );
+    assert( 0U != header->timestamp );
+    assert( 42U == header->producer );
+
+    uint64_t const first = header->timestamp;
+    plasma_header_stamp_lock( &( b.header ), 23U );
+    plasma_header_stamp_commit( &( b.header ), 2U, 1U );
+    assert( first <= header->timestamp );
+    assert( 2U == header->sequence );
+    assert( 23U == header->producer );
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests plasma shard mapping.
+ * \date        10/21/2026 03:31:02 PM
+ * \file        test_plasma_shard_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <ionize/universal.h>
+#include <plasma/shard.h>
+#include <stdint.h>
+
+#define SHARDS 8U
+#define UIDS 8000U
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( 0U == plasma_shard( 12345U, 0U ));
+    assert( 0U == plasma_shard( 12345U, 1U ));
+
+    /* sequential uids spread evenly, every shard gets its share */
+    uint32_t owned[ SHARDS ] = { 0U };
+    for( uint32_t uid = 1U; uid <= UIDS; ++uid )
+    {
+        uint32_t const shard = plasma_shard( uid, SHARDS );
+        assert( shard < SHARDS );
+        assert( shard == plasma_shard( uid, SHARDS ));
+        ++( owned[ shard ] );
+    }
+    for( uint32_t i = 0U; i < SHARDS; ++i )
+    {
+        assert( UIDS / SHARDS / 2U < owned[ i ] );
+        assert( owned[ i ] < UIDS / SHARDS * 2U );
+    }
+
+    uint32_t const shard = plasma_shard( 77U, SHARDS );
+    assert( ionize_port() + shard == plasma_shard_port( 77U, SHARDS ));
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests plasma_watermark_validator.
+ * \date        10/20/2026 03:25:40 PM
+ * \file        test_plasma_watermark_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <errno.h>
+#include <ionize/error.h>
+#include <ionize/universal.h>
+#include <plasma/watermark.h>
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    assert( 0 == plasma_watermark_validator( ( plasma_watermark ) {
+                PLASMA_WATERMARK_WRITABLE_BELOW,
+                10U,
+                PLASMA_WATERMARK_PERCENT
+    } ));
+    assert( 0 == plasma_watermark_validator( ( plasma_watermark ) {
+                PLASMA_WATERMARK_READABLE_ABOVE,
+                1000U,
+                PLASMA_WATERMARK_BUFFERS
+    } ));
+    assert( 0 == plasma_watermark_validator( ( plasma_watermark ) {
+                PLASMA_WATERMARK_READABLE_ABOVE,
+                100U,
+                PLASMA_WATERMARK_PERCENT
+    } ));
+    assert( ERANGE == plasma_watermark_validator( ( plasma_watermark ) {
+                PLASMA_WATERMARK_READABLE_ABOVE,
+                101U,
+                PLASMA_WATERMARK_PERCENT
+    } ));
+    assert( EINVAL == plasma_watermark_validator( ( plasma_watermark ) {
+                ( plasma_watermark_kind ) 2,
+                0U,
+                PLASMA_WATERMARK_BUFFERS
+    } ));
+    assert( EINVAL == plasma_watermark_validator( ( plasma_watermark ) {
+                PLASMA_WATERMARK_WRITABLE_BELOW,
+                0U,
+                ( plasma_watermark_unit ) 2
+    } ));
+
+    return 0;
+}
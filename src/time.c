@@ -0,0 +1,30 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Definition of monotonic time source.
+ * \date        10/19/2026 09:15:02 AM
+ * \file        time.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#define _POSIX_C_SOURCE 199309L /* for clock_gettime */
+
+#include <ionize/time.h>
+#include <stdint.h> /* uint64_t */
+#include <time.h> /* clock_gettime, struct timespec */
+
+#define NANOSECONDS_IN_SECOND 1000000000U
+
+uint64_t ionize_time( void )
+{
+    struct timespec result;
+
+    if( 0 == clock_gettime( CLOCK_MONOTONIC, &result ))
+    {
+        return (( uint64_t ) result.tv_sec ) * NANOSECONDS_IN_SECOND
+            + (( uint64_t ) result.tv_nsec );
+    }
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * \author      Mateusz Jemielity matthew.jemielity@gmail.com
+ * \brief       Tests ionize_time.
+ * \date        10/19/2026 09:20:31 AM
+ * \file        test_time_01.c
+ * \version     1.0
+ *
+ *
+ **/
+
+#include <assert.h>
+#include <ionize/time.h>
+#include <ionize/universal.h>
+#include <stdint.h>
+
+int main( int argc, char * args[] )
+{
+    UNUSED( argc );
+    UNUSED( args );
+
+    uint64_t previous = ionize_time();
+    assert( 0U != previous );
+    for( unsigned int i = 0; i < 1000U; ++i )
+    {
+        uint64_t const current = ionize_time();
+        assert( previous <= current );
+        previous = current;
+    }
+    return 0;
+}